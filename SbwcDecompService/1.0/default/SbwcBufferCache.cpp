@@ -0,0 +1,223 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "SbwcDecompService"
+
+#include <algorithm>
+#include <cinttypes>
+#include <vector>
+
+#include <cutils/properties.h>
+#include <log/log.h>
+#include "SbwcBufferCache.h"
+
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+#include <utils/Trace.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+SbwcImportedBuffer::~SbwcImportedBuffer()
+{
+    mGralloc.freeBuffer(mImported);
+}
+
+SbwcBufferCache::SbwcBufferCache(SbwcGralloc &gralloc, size_t capacity, std::chrono::milliseconds importTtl)
+    : mGralloc(gralloc), mCapacity(std::max<size_t>(1, capacity)), mImportTtl(importTtl),
+      mHits(0), mMisses(0), mImports(0)
+{
+    mExpiryThread = std::thread(&SbwcBufferCache::expiryLoop, this);
+}
+
+SbwcBufferCache::~SbwcBufferCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mExpiryCond.notify_all();
+
+    mExpiryThread.join();
+}
+
+bool SbwcBufferCache::lookup(const native_handle_t *handle, SbwcBufferInfo &info)
+{
+    if (!handle || handle->numFds < 1)
+        return false;
+
+    uint64_t bufferId = mGralloc.getBufferId(handle);
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        auto it = mIndex.find(bufferId);
+        if (it != mIndex.end()) {
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+            info = it->second->info;
+            mHits++;
+            return true;
+        }
+
+        mMisses++;
+    }
+
+    ATRACE_NAME("queryBufferMeta");
+
+    if (!mGralloc.getInfo(handle, info))
+        return false;
+
+    std::list<Entry> evicted;
+    std::lock_guard<std::mutex> lock(mLock);
+
+    // Another thread may have filled the same buffer meanwhile.
+    if (mIndex.find(bufferId) == mIndex.end())
+        insertLocked(info, nullptr, evicted);
+
+    return true;
+}
+
+std::shared_ptr<SbwcImportedBuffer> SbwcBufferCache::import(const native_handle_t *handle, const SbwcBufferInfo &info,
+                                                            uint32_t usage)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        auto it = mIndex.find(info.bufferId);
+        if (it != mIndex.end()) {
+            const auto &imported = it->second->imported;
+            if (imported && (imported->usage() & usage) == usage) {
+                it->second->used = Clock::now();
+                return imported;
+            }
+        }
+    }
+
+    ATRACE_NAME("importBuffer");
+
+    buffer_handle_t importedHandle = mGralloc.importBuffer(handle, info, usage);
+    if (!importedHandle) {
+        ALOGE("failed to import buffer %" PRIu64, info.bufferId);
+        return nullptr;
+    }
+
+    auto imported = std::make_shared<SbwcImportedBuffer>(mGralloc, importedHandle, usage);
+    mImports++;
+
+    // The replaced import and evicted entries are freed after the lock is dropped.
+    std::list<Entry> evicted;
+    std::shared_ptr<SbwcImportedBuffer> replaced;
+    std::lock_guard<std::mutex> lock(mLock);
+
+    auto it = mIndex.find(info.bufferId);
+    if (it == mIndex.end()) {
+        insertLocked(info, imported, evicted);
+    } else {
+        replaced = std::move(it->second->imported);
+        it->second->imported = imported;
+        it->second->used = Clock::now();
+    }
+
+    // The timer sleeps without a deadline while nothing is imported.
+    mExpiryCond.notify_all();
+
+    return imported;
+}
+
+void SbwcBufferCache::clear()
+{
+    std::list<Entry> entries;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        entries.swap(mEntries);
+        mIndex.clear();
+    }
+}
+
+void SbwcBufferCache::insertLocked(const SbwcBufferInfo &info, std::shared_ptr<SbwcImportedBuffer> imported,
+                                   std::list<Entry> &evicted)
+{
+    mEntries.push_front(Entry{ info, std::move(imported), Clock::now() });
+    mIndex[info.bufferId] = mEntries.begin();
+
+    if (mEntries.size() > mCapacity) {
+        mIndex.erase(mEntries.back().info.bufferId);
+        evicted.splice(evicted.end(), mEntries, std::prev(mEntries.end()));
+    }
+}
+
+void SbwcBufferCache::expiryLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (!mStop) {
+        bool imported = false;
+        Clock::time_point oldest = Clock::time_point::max();
+        for (const Entry &entry : mEntries) {
+            if (entry.imported) {
+                imported = true;
+                oldest = std::min(oldest, entry.used);
+            }
+        }
+
+        if (!imported) {
+            mExpiryCond.wait(lock);
+            continue;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (now < oldest + mImportTtl) {
+            mExpiryCond.wait_until(lock, oldest + mImportTtl);
+            continue;
+        }
+
+        // Imports are freed without the lock, decodes still using one keep it.
+        std::vector<std::shared_ptr<SbwcImportedBuffer>> expired;
+        for (Entry &entry : mEntries) {
+            if (entry.imported && now >= entry.used + mImportTtl)
+                expired.push_back(std::move(entry.imported));
+        }
+
+        lock.unlock();
+        expired.clear();
+        lock.lock();
+    }
+}
+
+size_t SbwcBufferCache::defaultCapacity()
+{
+    return static_cast<size_t>(std::max(1, property_get_int32("ro.vendor.sbwc.buffer_cache_size", 32)));
+}
+
+std::chrono::milliseconds SbwcBufferCache::defaultImportTtl()
+{
+    return std::chrono::milliseconds(std::max(1, property_get_int32("ro.vendor.sbwc.import_ttl_ms", 1000)));
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,135 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCBUFFERCACHE_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCBUFFERCACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <cutils/native_handle.h>
+
+#include "SbwcGralloc.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Gralloc import of one buffer, which also keeps it mapped. Shared by
+ * every decode that locks the buffer and freed with the last reference.
+ */
+class SbwcImportedBuffer {
+public:
+    SbwcImportedBuffer(SbwcGralloc &gralloc, buffer_handle_t imported, uint32_t usage)
+        : mGralloc(gralloc), mImported(imported), mUsage(usage) {}
+    ~SbwcImportedBuffer();
+
+    SbwcImportedBuffer(const SbwcImportedBuffer &) = delete;
+    SbwcImportedBuffer &operator=(const SbwcImportedBuffer &) = delete;
+
+    SbwcGralloc &gralloc() const { return mGralloc; }
+    buffer_handle_t handle() const { return mImported; }
+    uint32_t usage() const { return mUsage; }
+
+private:
+    SbwcGralloc &mGralloc;
+    buffer_handle_t mImported;
+    uint32_t mUsage;
+};
+
+/*
+ * LRU cache of gralloc metadata and imports, keyed by buffer id. Clients
+ * cycle through a small set of buffers, so most decodes find their
+ * buffers here and skip the metadata queries, and CPU passes skip the
+ * import and mapping.
+ *
+ * An import keeps the memory of its buffer alive, and the service is not
+ * told when a client frees one. Imports not used for the import TTL are
+ * therefore dropped by a timer thread, leaving only the metadata.
+ */
+class SbwcBufferCache {
+public:
+    SbwcBufferCache(SbwcGralloc &gralloc, size_t capacity, std::chrono::milliseconds importTtl);
+    ~SbwcBufferCache();
+
+    bool lookup(const native_handle_t *handle, SbwcBufferInfo &info);
+    // Import of handle usable for usage, or nullptr on failure.
+    std::shared_ptr<SbwcImportedBuffer> import(const native_handle_t *handle, const SbwcBufferInfo &info,
+                                               uint32_t usage);
+    // Drops every entry. Imports still in use are freed by their last user.
+    void clear();
+
+    uint64_t hits() const { return mHits; }
+    uint64_t misses() const { return mMisses; }
+    uint64_t imports() const { return mImports; }
+
+    // Cache size from ro.vendor.sbwc.buffer_cache_size.
+    static size_t defaultCapacity();
+    // ro.vendor.sbwc.import_ttl_ms.
+    static std::chrono::milliseconds defaultImportTtl();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        SbwcBufferInfo info;
+        std::shared_ptr<SbwcImportedBuffer> imported;
+        Clock::time_point used;     // last import() of the buffer
+    };
+
+    // Evicted entries go to evicted, to be destroyed once the lock is dropped.
+    void insertLocked(const SbwcBufferInfo &info, std::shared_ptr<SbwcImportedBuffer> imported,
+                      std::list<Entry> &evicted);
+
+    void expiryLoop();
+
+    SbwcGralloc &mGralloc;
+    const size_t mCapacity;
+    const std::chrono::milliseconds mImportTtl;
+
+    std::mutex mLock;
+    std::list<Entry> mEntries;      // most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> mIndex;
+
+    std::condition_variable mExpiryCond;
+    bool mStop = false;
+    std::thread mExpiryThread;
+
+    std::atomic<uint64_t> mHits;
+    std::atomic<uint64_t> mMisses;
+    std::atomic<uint64_t> mImports;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
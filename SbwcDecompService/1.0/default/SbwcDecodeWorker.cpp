@@ -0,0 +1,83 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SbwcDecodeWorker.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+SbwcDecodeWorker::SbwcDecodeWorker(size_t threads)
+    : mStop(false)
+{
+    mThreads.reserve(threads);
+    for (size_t i = 0; i < threads; i++)
+        mThreads.emplace_back(&SbwcDecodeWorker::threadLoop, this);
+}
+
+SbwcDecodeWorker::~SbwcDecodeWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mCond.notify_all();
+
+    for (auto &thread : mThreads)
+        thread.join();
+}
+
+void SbwcDecodeWorker::post(Clock::time_point deadline, std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        // Goes after the jobs with the same deadline.
+        mJobs.emplace(deadline, std::move(job));
+    }
+
+    mCond.notify_one();
+}
+
+void SbwcDecodeWorker::threadLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (true) {
+        mCond.wait(lock, [this] { return mStop || !mJobs.empty(); });
+
+        // Drain what is queued before stopping so no release fence is left unsignaled.
+        if (mJobs.empty())
+            return;
+
+        std::function<void()> job = std::move(mJobs.begin()->second);
+        mJobs.erase(mJobs.begin());
+
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
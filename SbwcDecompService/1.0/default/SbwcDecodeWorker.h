@@ -0,0 +1,69 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECODEWORKER_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECODEWORKER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Worker threads running decode jobs posted from binder threads that do
+ * not wait for the result. Jobs are started earliest deadline first, as
+ * the decoder pool serves its waiters, so a late posted 120 fps job does
+ * not queue behind best effort ones. Equal deadlines start in the order
+ * they are posted.
+ */
+class SbwcDecodeWorker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SbwcDecodeWorker(size_t threads);
+    ~SbwcDecodeWorker();
+
+    void post(Clock::time_point deadline, std::function<void()> job);
+
+private:
+    void threadLoop();
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::multimap<Clock::time_point, std::function<void()>> mJobs;
+    std::vector<std::thread> mThreads;
+    bool mStop;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <new>
+
+#include <hardware/exynos/sbwcwrapper.h>
+#include "SbwcDecoder.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+namespace {
+
+class SbwcWrapperDecoder : public SbwcDecoder {
+public:
+    bool decode(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate) override
+    {
+        return mWrapper.decode(static_cast<void*>(const_cast<native_handle_t*>(srcBH)),
+                               static_cast<void*>(const_cast<native_handle_t*>(dstBH)),
+                               attr, cropWidth, cropHeight, framerate);
+    }
+
+private:
+    SbwcWrapper mWrapper;
+};
+
+}  // namespace
+
+std::unique_ptr<SbwcDecoder> SbwcDecoder::createHardware()
+{
+    return std::unique_ptr<SbwcDecoder>(new (std::nothrow) SbwcWrapperDecoder());
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,56 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECODER_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECODER_H
+
+#include <cstdint>
+#include <memory>
+
+#include <cutils/native_handle.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * One decoder instance as seen by SbwcDecoderPool. The service only talks
+ * to the hardware through this, so the pool can be given a simulated
+ * decoder to exercise scheduling and concurrency without a device.
+ */
+class SbwcDecoder {
+public:
+    virtual ~SbwcDecoder() {}
+
+    virtual bool decode(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                        uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate) = 0;
+
+    // Decoder backed by SbwcWrapper, or nullptr when it cannot be created.
+    static std::unique_ptr<SbwcDecoder> createHardware();
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
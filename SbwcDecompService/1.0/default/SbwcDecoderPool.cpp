@@ -0,0 +1,240 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "SbwcDecompService"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include <cutils/properties.h>
+#include <log/log.h>
+#include "SbwcDecoderPool.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+SbwcDecoderPool::SbwcDecoderPool(size_t capacity, Clock::duration idleTimeout, Factory factory)
+    : mCapacity(std::max<size_t>(1, std::min(capacity, MAX_DECODERS))),
+      mIdleTimeout(idleTimeout),
+      mFactory(std::move(factory)),
+      mLastActive(Clock::now())
+{
+    mDecoders.reserve(mCapacity);
+    mIdle.reserve(mCapacity);
+
+    if (mIdleTimeout > Clock::duration::zero())
+        mIdleThread = std::thread(&SbwcDecoderPool::idleLoop, this);
+}
+
+SbwcDecoderPool::~SbwcDecoderPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mIdleCond.notify_all();
+
+    if (mIdleThread.joinable())
+        mIdleThread.join();
+}
+
+SbwcDecoderPool::Lease SbwcDecoderPool::acquire(Clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    if (!mWaiters.empty() || !available()) {
+        auto ticket = mWaiters.emplace(deadline, mArrivals++).first;
+        mWaits.fetch_add(1, std::memory_order_relaxed);
+
+        mCond.wait(lock, [this, ticket] { return available() && mWaiters.begin() == ticket; });
+
+        mWaiters.erase(ticket);
+        // More than one decoder may have come back, let the next waiter check.
+        if (!mWaiters.empty())
+            mCond.notify_all();
+    }
+
+    mLastActive = Clock::now();
+
+    // Nobody prewarmed, this caller creates one instance and the idle
+    // thread brings back the rest.
+    if (mCold)
+        warmLocked(mTornDown > 1 ? mTornDown - 1 : 0);
+
+    if (!mIdle.empty()) {
+        SbwcDecoder *decoder = mIdle.back();
+        mIdle.pop_back();
+        return Lease(this, decoder);
+    }
+
+    // The slot is reserved through mCreating, so the decoder is created
+    // without the lock and other callers keep getting idle instances.
+    mCreating++;
+    lock.unlock();
+    auto start = Clock::now();
+    std::unique_ptr<SbwcDecoder> created = mFactory();
+    auto end = Clock::now();
+    lock.lock();
+    mCreating--;
+
+    if (!created) {
+        ALOGE("failed to create decoder %zu of %zu", mDecoders.size(), mCapacity);
+        // The reserved slot is free again.
+        lock.unlock();
+        mCond.notify_all();
+        return Lease();
+    }
+
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    mLastCreateUs.store(us, std::memory_order_relaxed);
+    if (us > mMaxCreateUs.load(std::memory_order_relaxed))
+        mMaxCreateUs.store(us, std::memory_order_relaxed);
+
+    SbwcDecoder *decoder = created.get();
+    mDecoders.push_back(std::move(created));
+
+    return Lease(this, decoder);
+}
+
+void SbwcDecoderPool::prewarm()
+{
+    if (!mCold.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> lock(mLock);
+    if (mCold)
+        warmLocked(mTornDown);
+}
+
+void SbwcDecoderPool::warmLocked(size_t instances)
+{
+    // Counts as use, or the recreated instances would be torn down at once.
+    mLastActive = Clock::now();
+    mCold = false;
+    mPrewarm = instances;
+    mColdStarts.fetch_add(1, std::memory_order_relaxed);
+    mIdleCond.notify_all();
+}
+
+void SbwcDecoderPool::release(SbwcDecoder *decoder)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mIdle.push_back(decoder);
+        mLastActive = Clock::now();
+    }
+
+    // Waiters wait for their turn, so all of them have to look.
+    mCond.notify_all();
+}
+
+bool SbwcDecoderPool::hasWaiters()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return !mWaiters.empty();
+}
+
+void SbwcDecoderPool::setIdleHook(std::function<void()> hook)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mIdleHook = std::move(hook);
+}
+
+void SbwcDecoderPool::idleLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (!mStop) {
+        if (mPrewarm > 0) {
+            mPrewarm--;
+            if (mDecoders.size() + mCreating >= mCapacity)
+                continue;
+
+            // Created without the lock so that decodes keep going meanwhile.
+            mCreating++;
+            lock.unlock();
+            std::unique_ptr<SbwcDecoder> created = mFactory();
+            lock.lock();
+            mCreating--;
+
+            if (created) {
+                mIdle.push_back(created.get());
+                mDecoders.push_back(std::move(created));
+            }
+            mCond.notify_all();
+            continue;
+        }
+
+        if (mDecoders.empty() || mIdle.size() < mDecoders.size() || mCreating > 0) {
+            mIdleCond.wait_for(lock, mIdleTimeout);
+            continue;
+        }
+
+        Clock::time_point expiry = mLastActive + mIdleTimeout;
+        if (Clock::now() < expiry) {
+            mIdleCond.wait_until(lock, expiry);
+            continue;
+        }
+
+        std::vector<std::unique_ptr<SbwcDecoder>> decoders;
+        decoders.swap(mDecoders);
+        mIdle.clear();
+        mTornDown = decoders.size();
+        mCold = true;
+        mTeardowns.fetch_add(1, std::memory_order_relaxed);
+
+        ALOGD("releasing %zu idle decoders", decoders.size());
+
+        std::function<void()> hook = mIdleHook;
+        lock.unlock();
+        decoders.clear();
+        if (hook)
+            hook();
+        lock.lock();
+    }
+}
+
+size_t SbwcDecoderPool::defaultCapacity()
+{
+    int count = property_get_int32("ro.vendor.sbwc.decoder_count", 0);
+    if (count > 0)
+        return static_cast<size_t>(count);
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+SbwcDecoderPool::Clock::duration SbwcDecoderPool::defaultIdleTimeout()
+{
+    int ms = property_get_int32("ro.vendor.sbwc.idle_timeout_ms", 30000);
+
+    return std::chrono::milliseconds(std::max(0, ms));
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
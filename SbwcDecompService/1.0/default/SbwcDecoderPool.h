@@ -0,0 +1,152 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECODERPOOL_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECODERPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "SbwcDecoder.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Fixed set of decoder instances shared by all binder threads.
+ * Instances are created on first demand, and a caller that finds every
+ * instance busy sleeps until one is returned. Sleeping callers are
+ * served earliest deadline first.
+ *
+ * With an idle timeout, every instance is destroyed once none has been
+ * used for that long, and the idle hook is run so that other caches can
+ * let go of their memory too. prewarm() has them recreated in the
+ * background, so a call that prewarms when it arrives overlaps the
+ * creation with its own setup. An acquire that still finds the pool cold
+ * creates its own instance and has the rest recreated the same way.
+ */
+class SbwcDecoderPool {
+public:
+    class Lease {
+    public:
+        Lease() : mPool(nullptr), mDecoder(nullptr) {}
+        Lease(SbwcDecoderPool *pool, SbwcDecoder *decoder) : mPool(pool), mDecoder(decoder) {}
+        Lease(Lease &&other) : mPool(other.mPool), mDecoder(other.mDecoder) { other.mDecoder = nullptr; }
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        Lease &operator=(Lease &&other) {
+            std::swap(mPool, other.mPool);
+            std::swap(mDecoder, other.mDecoder);
+            return *this;
+        }
+        ~Lease() { if (mDecoder) mPool->release(mDecoder); }
+
+        SbwcDecoder *operator->() const { return mDecoder; }
+        explicit operator bool() const { return mDecoder != nullptr; }
+
+    private:
+        SbwcDecoderPool *mPool;
+        SbwcDecoder *mDecoder;
+    };
+
+    using Clock = std::chrono::steady_clock;
+    using Factory = std::function<std::unique_ptr<SbwcDecoder>()>;
+
+    SbwcDecoderPool(size_t capacity, Clock::duration idleTimeout, Factory factory = SbwcDecoder::createHardware);
+    ~SbwcDecoderPool();
+
+    Lease acquire(Clock::time_point deadline);
+    // Starts recreating torn down instances, does nothing unless cold.
+    void prewarm();
+    // Run on the idle thread, without the pool lock, after every teardown.
+    void setIdleHook(std::function<void()> hook);
+    size_t capacity() const { return mCapacity; }
+    // Whether a caller is sleeping for a decoder right now.
+    bool hasWaiters();
+    uint64_t waits() const { return mWaits.load(std::memory_order_relaxed); }
+
+    uint64_t teardowns() const { return mTeardowns.load(std::memory_order_relaxed); }
+    uint64_t coldStarts() const { return mColdStarts.load(std::memory_order_relaxed); }
+    // Time an acquire spent creating a decoder, last and worst.
+    uint64_t lastCreateUs() const { return mLastCreateUs.load(std::memory_order_relaxed); }
+    uint64_t maxCreateUs() const { return mMaxCreateUs.load(std::memory_order_relaxed); }
+
+    // Pool size from ro.vendor.sbwc.decoder_count, or the core count.
+    static size_t defaultCapacity();
+    // ro.vendor.sbwc.idle_timeout_ms, 0 keeps decoders forever.
+    static Clock::duration defaultIdleTimeout();
+
+private:
+    void release(SbwcDecoder *decoder);
+    bool available() const { return !mIdle.empty() || mDecoders.size() + mCreating < mCapacity; }
+    void idleLoop();
+    void warmLocked(size_t instances);
+
+    static constexpr size_t MAX_DECODERS = 8;
+
+    const size_t mCapacity;
+    const Clock::duration mIdleTimeout;
+    const Factory mFactory;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::vector<std::unique_ptr<SbwcDecoder>> mDecoders;
+    std::vector<SbwcDecoder *> mIdle;
+
+    // Sleeping callers by (deadline, arrival), so equal deadlines stay FIFO.
+    std::set<std::pair<Clock::time_point, uint64_t>> mWaiters;
+    uint64_t mArrivals = 0;
+    std::atomic<uint64_t> mWaits{0};
+
+    // Idle reclamation, all guarded by mLock.
+    std::condition_variable mIdleCond;
+    Clock::time_point mLastActive;
+    std::function<void()> mIdleHook;
+    size_t mCreating = 0;
+    size_t mTornDown = 0;       // instances destroyed by the last teardown
+    size_t mPrewarm = 0;        // instances still to recreate in the background
+    std::atomic<bool> mCold{false};     // written under mLock, read without it by prewarm()
+    bool mStop = false;
+    std::thread mIdleThread;
+
+    std::atomic<uint64_t> mTeardowns{0};
+    std::atomic<uint64_t> mColdStarts{0};
+    std::atomic<uint64_t> mLastCreateUs{0};
+    std::atomic<uint64_t> mMaxCreateUs{0};
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
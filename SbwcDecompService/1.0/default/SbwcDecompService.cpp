@@ -15,15 +15,28 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <condition_variable>
 #include <memory>
-
 #include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <cutils/properties.h>
+#include <unistd.h>
 
+#include <cutils/native_handle.h>
 #include <ExynosGraphicBuffer.h>
-#include <hardware/exynos/sbwcwrapper.h>
 #include "SbwcDecompService.h"
+#include "SbwcDecompSession.h"
+#include "SbwcFence.h"
+#include "SbwcImage.h"
 
 #define DEFAULT_FRAMERATE   1000
+#define SCRATCH_BUFFERS     2
 
 #define ATRACE_TAG ATRACE_TAG_GRAPHICS
 #include <utils/Trace.h>
@@ -35,7 +48,46 @@ namespace SbwcDecompService {
 namespace V1_0 {
 namespace implementation {
 
-using ::vendor::graphics::ExynosGraphicBufferMeta;
+namespace {
+
+void closeAndDelete(native_handle_t *handle)
+{
+    if (!handle)
+        return;
+
+    native_handle_close(handle);
+    native_handle_delete(handle);
+}
+
+}  // namespace
+
+SbwcDecompService::SbwcDecompService(SbwcDecoderPool::Factory decoderFactory, std::shared_ptr<SbwcGralloc> gralloc)
+    : mGralloc(std::move(gralloc)),
+      mBufferCache(*mGralloc, SbwcBufferCache::defaultCapacity(), SbwcBufferCache::defaultImportTtl()),
+      mOutputCache(mBufferCache),
+      mScratchPool(SCRATCH_BUFFERS),
+      mDecoderPool(SbwcDecoderPool::defaultCapacity(), SbwcDecoderPool::defaultIdleTimeout(),
+                   std::move(decoderFactory)),
+      mMaxPending(static_cast<uint32_t>(std::max(1, property_get_int32("ro.vendor.sbwc.max_pending",
+                                                                       defaultMaxPending(mDecoderPool.capacity()))))),
+      mPending(0),
+      mRejected(0),
+      mDeadlineMisses(0),
+      mMaxSessions(static_cast<uint32_t>(std::max(1, property_get_int32("ro.vendor.sbwc.max_sessions",
+                                                                        DEFAULT_MAX_SESSIONS)))),
+      mSessions(0),
+      mDecodeWorker(mDecoderPool.capacity()),
+      mStripeRunner(SbwcStripeRunner::defaultThreads())
+{
+    ALOGD("decoder pool capacity %zu, max pending %u", mDecoderPool.capacity(), mMaxPending);
+
+    // Nothing has been decoded for the idle timeout, drop what the caches pin.
+    mDecoderPool.setIdleHook([this]() {
+        mOutputCache.clear();
+        mBufferCache.clear();
+        mScratchPool.clear();
+    });
+}
 
 // Methods from ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_0::ISbwcDecompService follow.
 
@@ -48,13 +100,11 @@ Return<int32_t> SbwcDecompService::decode(const hidl_handle &srcHandle, const hi
 Return<int32_t> SbwcDecompService::decodeWithFramerate(const hidl_handle &srcHandle, const hidl_handle &dstHandle,
                                                        uint32_t attr, uint32_t framerate)
 {
-    auto *srcBH = static_cast<buffer_handle_t>(const_cast<native_handle_t*>(srcHandle.getNativeHandle()));
-    if (!srcBH)
+    SbwcBufferInfo srcInfo;
+    if (!mBufferCache.lookup(srcHandle.getNativeHandle(), srcInfo))
         return android::BAD_VALUE;
 
-    return decodeWithCropAndFps(srcHandle, dstHandle, attr,
-                                static_cast<unsigned int>(ExynosGraphicBufferMeta::get_width(srcBH)),
-                                static_cast<unsigned int>(ExynosGraphicBufferMeta::get_height(srcBH)), framerate);
+    return decodeWithCropAndFps(srcHandle, dstHandle, attr, srcInfo.width, srcInfo.height, framerate);
 }
 
 Return<int32_t> SbwcDecompService::decodeWithCrop(const hidl_handle &srcHandle, const hidl_handle &dstHandle,
@@ -66,38 +116,564 @@ Return<int32_t> SbwcDecompService::decodeWithCrop(const hidl_handle &srcHandle,
 Return<int32_t> SbwcDecompService::decodeWithCropAndFps(const hidl_handle &srcHandle, const hidl_handle &dstHandle,
                                                         uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate)
 {
-    static std::mutex mDecompMutex;
+    ATRACE_CALL();
+
+    auto *srcBH = srcHandle.getNativeHandle();
+    if (!srcBH)
+        return android::BAD_VALUE;
+
+    auto *dstBH = dstHandle.getNativeHandle();
+    if (!dstBH)
+        return android::BAD_VALUE;
+
+    SbwcDecompStats::Sample sample(SbwcDecompStats::METHOD_DECODE, attr);
+    int32_t error = ERROR_BUSY;
+
+    if (admit(sample)) {
+        error = runDecode(srcBH, dstBH, attr, cropWidth, cropHeight, framerate, sample);
+        retire();
+    }
+
+    mStats.record(sample, error);
+
+    return error;
+}
+
+// Methods from ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ISbwcDecompService follow.
+
+Return<int32_t> SbwcDecompService::decodeAsync(const hidl_handle &srcHandle, const hidl_handle &dstHandle,
+                                               uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate,
+                                               const hidl_handle &acquireFence, const sp<ISbwcDecodeCallback> &callback)
+{
+    ATRACE_CALL();
+
+    auto *srcBH = srcHandle.getNativeHandle();
+    auto *dstBH = dstHandle.getNativeHandle();
+    if (!srcBH || !dstBH || callback == nullptr)
+        return android::BAD_VALUE;
+
+    SbwcDecompStats::Sample sample(SbwcDecompStats::METHOD_ASYNC, attr);
+
+    if (!admit(sample)) {
+        mStats.record(sample, ERROR_BUSY);
+        return ERROR_BUSY;
+    }
+
+    // The handles of this call are closed once it returns, the job keeps its own.
+    native_handle_t *src = native_handle_clone(srcBH);
+    native_handle_t *dst = native_handle_clone(dstBH);
+    if (!src || !dst) {
+        closeAndDelete(src);
+        closeAndDelete(dst);
+
+        retire();
+        mStats.record(sample, android::NO_MEMORY);
+
+        return android::NO_MEMORY;
+    }
 
+    int acquireFd = -1;
+    auto *acquireBH = acquireFence.getNativeHandle();
+    if (acquireBH && acquireBH->numFds > 0)
+        acquireFd = dup(acquireBH->data[0]);
+
+    auto deadline = deadlineFor(framerate, sample.start);
+    mDecodeWorker.post(deadline, [this, src, dst, attr, cropWidth, cropHeight, framerate, acquireFd, callback,
+                                  sample]() mutable {
+        // Includes the acquire fence wait.
+        sample.phase[SbwcDecompStats::PHASE_QUEUE] = SbwcDecompStats::Clock::now() - sample.start;
+
+        int32_t error = android::TIMED_OUT;
+        if (waitAndCloseFence(acquireFd, ACQUIRE_FENCE_TIMEOUT_MS))
+            error = runDecode(src, dst, attr, cropWidth, cropHeight, framerate, sample);
+
+        // Reported on failure as well so the client never stalls.
+        auto ret = callback->onDecodeDone(error);
+        if (!ret.isOk())
+            ALOGW("failed to report async decode: %s", ret.description().c_str());
+
+        {
+            ATRACE_NAME("cleanup");
+            closeAndDelete(src);
+            closeAndDelete(dst);
+        }
+
+        retire();
+        mStats.record(sample, error);
+    });
+
+    return android::NO_ERROR;
+}
+
+Return<void> SbwcDecompService::decodeBatch(const hidl_vec<DecodeJob> &jobs, decodeBatch_cb _hidl_cb)
+{
     ATRACE_CALL();
 
-    std::lock_guard<std::mutex> lock(mDecompMutex);
+    hidl_vec<int32_t> errors;
+    errors.resize(jobs.size());
+
+    std::vector<SbwcDecompStats::Sample> samples;
+    samples.reserve(jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++)
+        samples.emplace_back(SbwcDecompStats::METHOD_BATCH, jobs[i].attr);
+
+    // The whole batch holds one binder thread, so it is admitted as one
+    // request and either runs completely or is turned away completely.
+    SbwcDecompStats::Sample admission(SbwcDecompStats::METHOD_BATCH, 0);
+    if (jobs.size() == 0 || !admit(admission)) {
+        for (size_t i = 0; i < jobs.size(); i++) {
+            errors[i] = ERROR_BUSY;
+            mStats.record(samples[i], ERROR_BUSY);
+        }
+
+        _hidl_cb(errors);
+        return Void();
+    }
+
+    // At most one runner per decoder takes jobs in order. Each keeps its
+    // decoder from one job to the next unless another caller is waiting
+    // for one, so the pool is not gone through for every job.
+    std::atomic<size_t> next(0);
+    auto run = [this, &jobs, &errors, &samples, &next, &admission]() {
+        SbwcDecoderPool::Lease decoder;
+
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            SbwcDecompStats::Sample &sample = samples[i];
+            sample.contended = admission.contended;
+            sample.phase[SbwcDecompStats::PHASE_QUEUE] = SbwcDecompStats::Clock::now() - sample.start;
+
+            errors[i] = runJob(jobs[i], sample, decoder);
+            mStats.record(sample, errors[i]);
+
+            if (decoder && mDecoderPool.hasWaiters())
+                decoder = SbwcDecoderPool::Lease();
+        }
+    };
+
+    std::mutex doneLock;
+    std::condition_variable doneCond;
+    const size_t posted = std::min(jobs.size(), mDecoderPool.capacity()) - 1;
+    size_t remaining = posted;
+
+    // The runners are queued with the most urgent job of the batch.
+    auto deadline = SbwcDecoderPool::Clock::time_point::max();
+    for (size_t i = 0; i < jobs.size(); i++)
+        deadline = std::min(deadline, deadlineFor(jobs[i].framerate, samples[i].start));
+
+    // The binder thread is one of the runners instead of idling. The jobs
+    // refer to the handles of this call directly since it does not return
+    // before they finish.
+    for (size_t n = 0; n < posted; n++) {
+        mDecodeWorker.post(deadline, [&run, &doneLock, &doneCond, &remaining]() {
+            run();
+
+            std::lock_guard<std::mutex> lock(doneLock);
+            if (--remaining == 0)
+                doneCond.notify_one();
+        });
+    }
+
+    run();
+
+    {
+        std::unique_lock<std::mutex> lock(doneLock);
+        doneCond.wait(lock, [&remaining] { return remaining == 0; });
+    }
+
+    retire();
+    _hidl_cb(errors);
+
+    return Void();
+}
+
+Return<int32_t> SbwcDecompService::decodeWithRegion(const hidl_handle &srcHandle, const hidl_handle &dstHandle,
+                                                    uint32_t attr, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                                    uint32_t framerate)
+{
+    ATRACE_CALL();
+
+    auto *srcBH = srcHandle.getNativeHandle();
+    auto *dstBH = dstHandle.getNativeHandle();
+    if (!srcBH || !dstBH || width == 0 || height == 0)
+        return android::BAD_VALUE;
+
+    SbwcDecompStats::Sample sample(SbwcDecompStats::METHOD_REGION, attr);
+    int32_t error = ERROR_BUSY;
+
+    if (admit(sample)) {
+        error = runRegionDecode(srcBH, dstBH, attr, x, y, width, height, framerate, sample);
+        retire();
+    }
+
+    mStats.record(sample, error);
+
+    return error;
+}
+
+Return<int32_t> SbwcDecompService::decodeWithScale(const hidl_handle &srcHandle, const hidl_handle &dstHandle,
+                                                   uint32_t attr, uint32_t scaleShift, ScaleFilter filter,
+                                                   uint32_t framerate)
+{
+    ATRACE_CALL();
+
+    auto *srcBH = srcHandle.getNativeHandle();
+    auto *dstBH = dstHandle.getNativeHandle();
+    if (!srcBH || !dstBH || filter != ScaleFilter::BOX || scaleShift > MAX_SCALE_SHIFT)
+        return android::BAD_VALUE;
+
+    SbwcDecompStats::Sample sample(SbwcDecompStats::METHOD_SCALE, attr);
+    int32_t error = ERROR_BUSY;
+
+    if (admit(sample)) {
+        error = runScaledDecode(srcBH, dstBH, attr, scaleShift, framerate, sample);
+        retire();
+    }
+
+    mStats.record(sample, error);
+
+    return error;
+}
+
+Return<void> SbwcDecompService::openSession(openSession_cb _hidl_cb)
+{
+    if (!acquireSession()) {
+        _hidl_cb(ERROR_BUSY, nullptr);
+        return Void();
+    }
+
+    // Once constructed, the session releases its reservation on close.
+    android::sp<SbwcDecompSession> session = new (std::nothrow) SbwcDecompSession(this);
+    if (session == nullptr) {
+        releaseSession();
+        _hidl_cb(android::NO_MEMORY, nullptr);
+        return Void();
+    }
+
+    if (!session->valid()) {
+        _hidl_cb(android::NO_MEMORY, nullptr);
+        return Void();
+    }
+
+    _hidl_cb(android::NO_ERROR, session);
+
+    return Void();
+}
+
+SbwcDecoderPool::Clock::time_point SbwcDecompService::deadlineFor(uint32_t framerate,
+                                                                  SbwcDecoderPool::Clock::time_point arrival)
+{
+    // DEFAULT_FRAMERATE is what callers without a hint get, so it must not
+    // rank them ahead of real 60 or 120 fps streams.
+    if (framerate == 0 || framerate >= DEFAULT_FRAMERATE)
+        return arrival + BEST_EFFORT_DEADLINE;
+
+    return arrival + std::chrono::microseconds(1000000 / framerate);
+}
+
+int32_t SbwcDecompService::defaultRpcThreads()
+{
+    return std::max(1, property_get_int32("ro.vendor.sbwc.rpc_threads", 4));
+}
+
+int32_t SbwcDecompService::defaultMaxPending(size_t decoders)
+{
+    // A synchronous caller holds its binder thread while pending. With as
+    // many slots as threads, the next caller would wait unseen in the
+    // hwbinder queue instead of getting ERROR_BUSY, so one thread is kept
+    // free to turn callers away.
+    int32_t threads = defaultRpcThreads();
+    int32_t pending = static_cast<int32_t>(decoders * 2);
+
+    return std::max(1, std::min(pending, threads - 1));
+}
+
+bool SbwcDecompService::admit(SbwcDecompStats::Sample &sample)
+{
+    uint32_t pending = mPending.fetch_add(1, std::memory_order_relaxed);
+    if (pending < mMaxPending) {
+        sample.contended = pending > 0;
+        // After idle, decoders come back while the call looks up its
+        // buffers and waits for its fence, not once it needs one.
+        mDecoderPool.prewarm();
+        return true;
+    }
+
+    mPending.fetch_sub(1, std::memory_order_relaxed);
+    uint64_t rejected = mRejected.fetch_add(1, std::memory_order_relaxed) + 1;
+    ALOGW("decode rejected, %u requests pending (%" PRIu64 " rejected so far)", mMaxPending, rejected);
+
+    return false;
+}
+
+void SbwcDecompService::retire()
+{
+    mPending.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool SbwcDecompService::acquireSession()
+{
+    if (mSessions.fetch_add(1, std::memory_order_relaxed) < mMaxSessions)
+        return true;
+
+    mSessions.fetch_sub(1, std::memory_order_relaxed);
+    ALOGW("session rejected, %u sessions open", mMaxSessions);
+
+    return false;
+}
+
+void SbwcDecompService::releaseSession()
+{
+    mSessions.fetch_sub(1, std::memory_order_relaxed);
+}
 
-    static SbwcWrapper *decoder;
+int32_t SbwcDecompService::runDecode(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                                     uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate,
+                                     SbwcDecompStats::Sample &sample)
+{
+    SbwcDecoderPool::Lease decoder;
 
-    if (!decoder) {
-        decoder = new SbwcWrapper();
+    return runDecode(srcBH, dstBH, attr, cropWidth, cropHeight, framerate, sample, decoder);
+}
+
+int32_t SbwcDecompService::runDecode(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                                     uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate,
+                                     SbwcDecompStats::Sample &sample, SbwcDecoderPool::Lease &decoder)
+{
+    sample.pixels = static_cast<uint64_t>(cropWidth) * cropHeight;
+
+    SbwcBufferInfo srcInfo, dstInfo;
+    bool cacheable = false;
+
+    if (mOutputCache.enabled()) {
+        ATRACE_NAME("import");
+        cacheable = mBufferCache.lookup(srcBH, srcInfo) && mBufferCache.lookup(dstBH, dstInfo);
+    }
+
+    if (cacheable) {
+        if (mOutputCache.reuse(srcInfo, dstInfo, dstBH, attr, cropWidth, cropHeight))
+            return android::NO_ERROR;
+
+        mOutputCache.invalidate(dstInfo);
+    }
+
+    auto deadline = deadlineFor(framerate, sample.start);
+
+    {
+        auto start = SbwcDecompStats::Clock::now();
+        if (!decoder) {
+            ATRACE_NAME("poolWait");
+            decoder = mDecoderPool.acquire(deadline);
+        }
         if (!decoder)
             return android::NO_MEMORY;
+
+        auto acquired = SbwcDecompStats::Clock::now();
+        sample.phase[SbwcDecompStats::PHASE_POOL] = acquired - start;
+
+        ATRACE_NAME("decode");
+        bool decoded = decoder->decode(srcBH, dstBH, attr, cropWidth, cropHeight, framerate);
+        sample.phase[SbwcDecompStats::PHASE_DECODE] = SbwcDecompStats::Clock::now() - acquired;
+
+        if (!decoded) {
+            ALOGE("decode is failed");
+            return android::BAD_VALUE;
+        }
     }
 
-    auto *srcBH = const_cast<native_handle_t*>(srcHandle.getNativeHandle());
-    if (!srcBH)
+    if (SbwcDecoderPool::Clock::now() > deadline)
+        mDeadlineMisses++;
+
+    if (cacheable)
+        mOutputCache.store(srcInfo, dstInfo, dstBH, attr, cropWidth, cropHeight);
+
+    return android::NO_ERROR;
+}
+
+int32_t SbwcDecompService::runJob(const DecodeJob &job, SbwcDecompStats::Sample &sample,
+                                  SbwcDecoderPool::Lease &decoder)
+{
+    auto *srcBH = job.srcHandle.getNativeHandle();
+    auto *dstBH = job.dstHandle.getNativeHandle();
+    if (!srcBH || !dstBH)
         return android::BAD_VALUE;
 
-    auto *dstBH = const_cast<native_handle_t*>(dstHandle.getNativeHandle());
-    if (!dstBH)
+    return runJobOn(srcBH, dstBH, job.attr, job.cropWidth, job.cropHeight, job.framerate, sample, decoder);
+}
+
+int32_t SbwcDecompService::runJobOn(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                                    uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate,
+                                    SbwcDecompStats::Sample &sample, SbwcDecoderPool::Lease &decoder)
+{
+    if (cropWidth == 0 || cropHeight == 0) {
+        SbwcBufferInfo srcInfo;
+        if (!mBufferCache.lookup(srcBH, srcInfo))
+            return android::BAD_VALUE;
+
+        cropWidth = srcInfo.width;
+        cropHeight = srcInfo.height;
+    }
+
+    return runDecode(srcBH, dstBH, attr, cropWidth, cropHeight,
+                     framerate ? framerate : DEFAULT_FRAMERATE, sample, decoder);
+}
+
+int32_t SbwcDecompService::runSessionJob(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                                         const SessionJob &job)
+{
+    SbwcDecompStats::Sample sample(SbwcDecompStats::METHOD_SESSION, job.attr);
+    int32_t error = ERROR_BUSY;
+
+    if (admit(sample)) {
+        SbwcDecoderPool::Lease decoder;
+        error = runJobOn(srcBH, dstBH, job.attr, job.cropWidth, job.cropHeight, job.framerate, sample, decoder);
+        retire();
+    }
+
+    mStats.record(sample, error);
+
+    return error;
+}
+
+int32_t SbwcDecompService::runRegionDecode(const native_handle_t *srcBH, const native_handle_t *dstBH, uint32_t attr,
+                                           uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t framerate,
+                                           SbwcDecompStats::Sample &sample)
+{
+    // The wrapper crops from the origin only, so that case is decoded directly.
+    if (x == 0 && y == 0)
+        return runDecode(srcBH, dstBH, attr, width, height, framerate, sample);
+
+    SbwcBufferInfo srcInfo, dstInfo;
+    if (!mBufferCache.lookup(srcBH, srcInfo) || !mBufferCache.lookup(dstBH, dstInfo))
         return android::BAD_VALUE;
 
-    if (!decoder->decode(static_cast<void*>(srcBH), static_cast<void*>(dstBH), attr, cropWidth, cropHeight, framerate)) {
-        ALOGE("decode is failed");
+    if ((x | y | width | height) & 1 ||
+        x + width > srcInfo.width || y + height > srcInfo.height ||
+        width > dstInfo.width || height > dstInfo.height)
         return android::BAD_VALUE;
+
+    // Otherwise the smallest origin crop covering the region is decoded
+    // into a scratch buffer of just that size and only the region is
+    // copied out. The decoder cannot start at an offset, so the rows above
+    // and the columns left of the region are still decoded and written;
+    // a region near the bottom right costs close to a full frame.
+    android::sp<android::GraphicBuffer> scratch = mScratchPool.acquire(x + width, y + height, dstInfo.format);
+    if (scratch == nullptr)
+        return android::NO_MEMORY;
+
+    int32_t error = runDecode(srcBH, scratch->handle, attr, x + width, y + height, framerate, sample);
+    if (error == android::NO_ERROR) {
+        ATRACE_NAME("copyRegion");
+
+        SbwcLockedImage from(scratch, GRALLOC_USAGE_SW_READ_OFTEN);
+        SbwcLockedImage to(mBufferCache.import(dstBH, dstInfo, GRALLOC_USAGE_SW_WRITE_OFTEN), dstInfo,
+                           GRALLOC_USAGE_SW_WRITE_OFTEN);
+
+        if (!from.valid() || !to.valid() || !copyRegion(from.image(), x, y, to.image(), width, height)) {
+            ALOGE("failed to copy %ux%u region at (%u, %u)", width, height, x, y);
+            error = android::BAD_VALUE;
+        }
     }
 
-    return android::NO_ERROR;
+    mScratchPool.release(scratch);
+
+    return error;
+}
+
+int32_t SbwcDecompService::runScaledDecode(const native_handle_t *srcBH, const native_handle_t *dstBH, uint32_t attr,
+                                           uint32_t scaleShift, uint32_t framerate, SbwcDecompStats::Sample &sample)
+{
+    SbwcBufferInfo srcInfo, dstInfo;
+    if (!mBufferCache.lookup(srcBH, srcInfo) || !mBufferCache.lookup(dstBH, dstInfo))
+        return android::BAD_VALUE;
+
+    if (scaleShift == 0)
+        return runDecode(srcBH, dstBH, attr, srcInfo.width, srcInfo.height, framerate, sample);
+
+    // The decoder has no scaler, so the full frame is decoded at full size
+    // whatever the scale and this mode saves no decode bandwidth over a
+    // plain decode, only the client's own filtering pass.
+    //
+    // A destination that can hold the full frame takes the decode itself
+    // and is filtered in place, without a scratch buffer. Stripes would
+    // overwrite rows that another stripe still reads, so that pass runs on
+    // one thread, and the full size decode is left around the result.
+    if (dstInfo.width >= srcInfo.width && dstInfo.height >= srcInfo.height) {
+        int32_t error = runDecode(srcBH, dstBH, attr, srcInfo.width, srcInfo.height, framerate, sample);
+        if (error != android::NO_ERROR)
+            return error;
+
+        ATRACE_NAME("boxDownscale");
+
+        constexpr uint32_t usage = GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN;
+        SbwcLockedImage image(mBufferCache.import(dstBH, dstInfo, usage), dstInfo, usage);
+        if (!image.valid())
+            return android::BAD_VALUE;
+
+        SbwcImage frame = image.image();
+        frame.width = srcInfo.width;
+        frame.height = srcInfo.height;
+
+        if (!boxDownscale(frame, image.image(), scaleShift)) {
+            ALOGE("failed to scale %ux%u by 1/%u", srcInfo.width, srcInfo.height, 1u << scaleShift);
+            return android::BAD_VALUE;
+        }
+
+        return android::NO_ERROR;
+    }
+
+    // Otherwise the full frame goes to a pooled scratch buffer, so steady
+    // thumbnailing does not allocate, and is filtered straight into the
+    // client buffer.
+    android::sp<android::GraphicBuffer> scratch = mScratchPool.acquire(srcInfo.width, srcInfo.height, dstInfo.format);
+    if (scratch == nullptr)
+        return android::NO_MEMORY;
+
+    int32_t error = runDecode(srcBH, scratch->handle, attr, srcInfo.width, srcInfo.height, framerate, sample);
+    if (error == android::NO_ERROR) {
+        ATRACE_NAME("boxDownscale");
+
+        SbwcLockedImage from(scratch, GRALLOC_USAGE_SW_READ_OFTEN);
+        SbwcLockedImage to(mBufferCache.import(dstBH, dstInfo, GRALLOC_USAGE_SW_WRITE_OFTEN), dstInfo,
+                           GRALLOC_USAGE_SW_WRITE_OFTEN);
+
+        if (!from.valid() || !to.valid() || !boxDownscale(from.image(), to.image(), scaleShift, &mStripeRunner)) {
+            ALOGE("failed to scale %ux%u by 1/%u", srcInfo.width, srcInfo.height, 1u << scaleShift);
+            error = android::BAD_VALUE;
+        }
+    }
+
+    mScratchPool.release(scratch);
+
+    return error;
 }
 
 // Methods from ::android::hidl::base::V1_0::IBase follow.
 
+Return<void> SbwcDecompService::debug(const hidl_handle &fd, const hidl_vec<hidl_string> & /* options */)
+{
+    auto *fdBH = fd.getNativeHandle();
+    if (!fdBH || fdBH->numFds < 1)
+        return Void();
+
+    int dumpFd = fdBH->data[0];
+
+    dprintf(dumpFd, "SbwcDecompService\n");
+    dprintf(dumpFd, "Decoders: %zu, pending %u/%u, rejected %" PRIu64 "\n", mDecoderPool.capacity(),
+            mPending.load(), mMaxPending, mRejected.load());
+    dprintf(dumpFd, "Sessions: %u/%u\n", mSessions.load(), mMaxSessions);
+    dprintf(dumpFd, "Scheduling: waited for decoder %" PRIu64 ", deadline misses %" PRIu64 "\n",
+            mDecoderPool.waits(), mDeadlineMisses.load());
+    dprintf(dumpFd, "Idle: teardowns %" PRIu64 ", cold starts %" PRIu64 ", decoder create last %" PRIu64
+            " us, max %" PRIu64 " us\n", mDecoderPool.teardowns(), mDecoderPool.coldStarts(),
+            mDecoderPool.lastCreateUs(), mDecoderPool.maxCreateUs());
+    mStats.dump(dumpFd);
+    dprintf(dumpFd, "Buffer cache: hits %" PRIu64 ", misses %" PRIu64 ", imports %" PRIu64 "\n",
+            mBufferCache.hits(), mBufferCache.misses(), mBufferCache.imports());
+    mOutputCache.dump(dumpFd);
+
+    return Void();
+}
+
 //
 }  // namespace implementation
 }  // namespace V1_0
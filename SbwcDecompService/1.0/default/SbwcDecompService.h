@@ -18,12 +18,26 @@
 #ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECOMPSERVICE_H
 #define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECOMPSERVICE_H
 
-#include <vendor/samsung_slsi/hardware/SbwcDecompService/1.0/ISbwcDecompService.h>
+#include <vendor/samsung_slsi/hardware/SbwcDecompService/1.1/ISbwcDecompService.h>
 #include <hidl/MQDescriptor.h>
 #include <hidl/Status.h>
 
 #include <log/log.h>
 
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <memory>
+
+#include "SbwcBufferCache.h"
+#include "SbwcDecoderPool.h"
+#include "SbwcDecompStats.h"
+#include "SbwcDecodeWorker.h"
+#include "SbwcGralloc.h"
+#include "SbwcOutputCache.h"
+#include "SbwcScratchPool.h"
+#include "SbwcStripeRunner.h"
+
 namespace vendor {
 namespace samsung_slsi {
 namespace hardware {
@@ -32,17 +46,102 @@ namespace V1_0 {
 namespace implementation {
 
 using ::android::hardware::hidl_handle;
+using ::android::hardware::hidl_string;
+using ::android::hardware::hidl_vec;
 using ::android::hardware::Return;
+using ::android::hardware::Void;
+using ::android::sp;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::DecodeJob;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ISbwcDecodeCallback;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ScaleFilter;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::SessionJob;
+
+struct SbwcDecompService : public V1_1::ISbwcDecompService {
+    // Tests pass a simulated decoder and fake buffers, the service uses the defaults.
+    explicit SbwcDecompService(SbwcDecoderPool::Factory decoderFactory = SbwcDecoder::createHardware,
+                               std::shared_ptr<SbwcGralloc> gralloc = SbwcGralloc::createDefault());
 
-struct SbwcDecompService : public ISbwcDecompService {
     // Methods from ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_0::ISbwcDecompService follow.
     Return<int32_t> decode(const hidl_handle &srcHandle, const hidl_handle &dstHandle, uint32_t attr) override;
     Return<int32_t> decodeWithFramerate(const hidl_handle &srcHandle, const hidl_handle &dstHandle, uint32_t attr, uint32_t framerate) override;
     Return<int32_t> decodeWithCrop(const hidl_handle &srcHandle, const hidl_handle &dstHandle, uint32_t attr, uint32_t cropWidth, uint32_t cropHeight) override;
     Return<int32_t> decodeWithCropAndFps(const hidl_handle &srcHandle, const hidl_handle &dstHandle, uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate) override;
 
+    // Methods from ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ISbwcDecompService follow.
+    Return<int32_t> decodeAsync(const hidl_handle &srcHandle, const hidl_handle &dstHandle, uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate, const hidl_handle &acquireFence, const sp<ISbwcDecodeCallback> &callback) override;
+    Return<void> decodeBatch(const hidl_vec<DecodeJob> &jobs, decodeBatch_cb _hidl_cb) override;
+    Return<int32_t> decodeWithRegion(const hidl_handle &srcHandle, const hidl_handle &dstHandle, uint32_t attr, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t framerate) override;
+    Return<int32_t> decodeWithScale(const hidl_handle &srcHandle, const hidl_handle &dstHandle, uint32_t attr, uint32_t scaleShift, ScaleFilter filter, uint32_t framerate) override;
+    Return<void> openSession(openSession_cb _hidl_cb) override;
+
     // Methods from ::android::hidl::base::V1_0::IBase follow.
+    Return<void> debug(const hidl_handle &fd, const hidl_vec<hidl_string> &options) override;
+
+    // Returned by every decode method when the pending queue is full.
+    static constexpr int32_t ERROR_BUSY = -EBUSY;
+
+    // Runs one job of a session, on the thread of that session.
+    int32_t runSessionJob(const native_handle_t *srcBH, const native_handle_t *dstBH, const SessionJob &job);
+
+    // Gives back the reservation of a closed session.
+    void releaseSession();
+
+    // ro.vendor.sbwc.rpc_threads, binder threads of the service.
+    static int32_t defaultRpcThreads();
+
+private:
+    bool admit(SbwcDecompStats::Sample &sample);
+    void retire();
+    bool acquireSession();
+    int32_t runDecode(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                      uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate,
+                      SbwcDecompStats::Sample &sample);
+    // Decodes with the given lease, taking a decoder first if it holds none.
+    int32_t runDecode(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                      uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate,
+                      SbwcDecompStats::Sample &sample, SbwcDecoderPool::Lease &decoder);
+    int32_t runJob(const DecodeJob &job, SbwcDecompStats::Sample &sample, SbwcDecoderPool::Lease &decoder);
+    int32_t runJobOn(const native_handle_t *srcBH, const native_handle_t *dstBH,
+                     uint32_t attr, uint32_t cropWidth, uint32_t cropHeight, uint32_t framerate,
+                     SbwcDecompStats::Sample &sample, SbwcDecoderPool::Lease &decoder);
+    int32_t runRegionDecode(const native_handle_t *srcBH, const native_handle_t *dstBH, uint32_t attr,
+                            uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t framerate,
+                            SbwcDecompStats::Sample &sample);
+    int32_t runScaledDecode(const native_handle_t *srcBH, const native_handle_t *dstBH, uint32_t attr,
+                            uint32_t scaleShift, uint32_t framerate, SbwcDecompStats::Sample &sample);
+
+    // Counted from when the request arrived, so queued work does not slide back.
+    static SbwcDecoderPool::Clock::time_point deadlineFor(uint32_t framerate,
+                                                         SbwcDecoderPool::Clock::time_point arrival);
+    static int32_t defaultMaxPending(size_t decoders);
+
+    static constexpr int ACQUIRE_FENCE_TIMEOUT_MS = 3000;
+    // Deadline of decodes that carry no framerate hint.
+    static constexpr std::chrono::milliseconds BEST_EFFORT_DEADLINE{1000};
+    static constexpr uint32_t MAX_SCALE_SHIFT = 4;
+
+    const std::shared_ptr<SbwcGralloc> mGralloc;
+    SbwcBufferCache mBufferCache;
+    SbwcOutputCache mOutputCache;
+    SbwcScratchPool mScratchPool;
+    // After the caches, so its idle thread is stopped before they go away.
+    SbwcDecoderPool mDecoderPool;
+
+    // Admission control: decodes running, queued or waiting for a decoder.
+    const uint32_t mMaxPending;
+    std::atomic<uint32_t> mPending;
+    std::atomic<uint64_t> mRejected;
+    std::atomic<uint64_t> mDeadlineMisses;
+
+    // Each session holds a thread and up to 64 buffer handles.
+    static constexpr int32_t DEFAULT_MAX_SESSIONS = 16;
+    const uint32_t mMaxSessions;
+    std::atomic<uint32_t> mSessions;
+
+    SbwcDecodeWorker mDecodeWorker;
+    SbwcStripeRunner mStripeRunner;
 
+    SbwcDecompStats mStats;
 };
 
 
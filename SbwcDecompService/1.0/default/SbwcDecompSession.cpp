@@ -0,0 +1,215 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "SbwcDecompService"
+
+#include <new>
+
+#include <cutils/native_handle.h>
+#include <log/log.h>
+#include "SbwcDecompService.h"
+#include "SbwcDecompSession.h"
+
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+#include <utils/Trace.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::hardware::Void;
+
+namespace {
+
+void closeAndDelete(native_handle_t *handle)
+{
+    native_handle_close(handle);
+    native_handle_delete(handle);
+}
+
+}  // namespace
+
+SbwcDecompSession::SbwcDecompSession(SbwcDecompService *service)
+    : mService(service),
+      mSubmitQueue(new (std::nothrow) SubmitQueue(QUEUE_SIZE, true)),
+      mCompletionQueue(new (std::nothrow) CompletionQueue(QUEUE_SIZE, true)),
+      mClosed(false),
+      mStop(false)
+{
+    if (!mSubmitQueue || !mSubmitQueue->isValid() || !mCompletionQueue || !mCompletionQueue->isValid()) {
+        ALOGE("failed to create session queues");
+        return;
+    }
+
+    mThread = std::thread(&SbwcDecompSession::threadLoop, this);
+}
+
+SbwcDecompSession::~SbwcDecompSession()
+{
+    close();
+}
+
+// Methods from ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ISbwcDecompSession follow.
+
+Return<void> SbwcDecompSession::registerBuffers(const hidl_vec<hidl_handle> &buffers, registerBuffers_cb _hidl_cb)
+{
+    hidl_vec<uint32_t> indices;
+    indices.resize(buffers.size());
+
+    std::lock_guard<std::mutex> lock(mBuffersLock);
+
+    // Frees the slots filled so far, a failed call registers nothing.
+    auto fail = [this, &indices, &_hidl_cb](size_t filled, int32_t error) {
+        for (size_t i = 0; i < filled; i++)
+            mBuffers[indices[i]].reset();
+
+        _hidl_cb(error, hidl_vec<uint32_t>());
+        return Void();
+    };
+
+    size_t slot = 0;
+    for (size_t i = 0; i < buffers.size(); i++) {
+        auto *handle = buffers[i].getNativeHandle();
+        native_handle_t *clone = handle ? native_handle_clone(handle) : nullptr;
+        if (!clone)
+            return fail(i, handle ? android::NO_MEMORY : android::BAD_VALUE);
+
+        while (slot < mBuffers.size() && mBuffers[slot])
+            slot++;
+
+        if (slot == mBuffers.size()) {
+            if (slot == MAX_BUFFERS) {
+                closeAndDelete(clone);
+                return fail(i, android::NO_MEMORY);
+            }
+            mBuffers.emplace_back();
+        }
+
+        mBuffers[slot].reset(clone, closeAndDelete);
+        indices[i] = static_cast<uint32_t>(slot);
+    }
+
+    _hidl_cb(android::NO_ERROR, indices);
+
+    return Void();
+}
+
+Return<int32_t> SbwcDecompSession::unregisterBuffers(const hidl_vec<uint32_t> &indices)
+{
+    std::lock_guard<std::mutex> lock(mBuffersLock);
+
+    int32_t error = android::NO_ERROR;
+    for (uint32_t index : indices) {
+        if (index < mBuffers.size() && mBuffers[index])
+            mBuffers[index].reset();
+        else
+            error = android::BAD_VALUE;
+    }
+
+    return error;
+}
+
+Return<void> SbwcDecompSession::getQueues(getQueues_cb _hidl_cb)
+{
+    if (!valid()) {
+        _hidl_cb(android::NO_INIT, SubmitQueue::Descriptor(), CompletionQueue::Descriptor());
+        return Void();
+    }
+
+    _hidl_cb(android::NO_ERROR, *mSubmitQueue->getDesc(), *mCompletionQueue->getDesc());
+
+    return Void();
+}
+
+Return<void> SbwcDecompSession::close()
+{
+    // Serializes close from the client with the one of the destructor.
+    std::lock_guard<std::mutex> closeLock(mCloseLock);
+
+    if (mClosed)
+        return Void();
+    mClosed = true;
+
+    mStop = true;
+
+    if (mThread.joinable() && mThread.get_id() != std::this_thread::get_id())
+        mThread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(mBuffersLock);
+        mBuffers.clear();
+    }
+
+    mService->releaseSession();
+
+    return Void();
+}
+
+void SbwcDecompSession::threadLoop()
+{
+    while (!mStop) {
+        SessionJob job;
+        if (!mSubmitQueue->readBlocking(&job, 1, POLL_TIMEOUT_NS))
+            continue;
+
+        SessionCompletion completion;
+        completion.cookie = job.cookie;
+        completion.error = run(job);
+
+        // Every job gets its completion, so a full queue is waited out.
+        // No job is read meanwhile, and a client that stops reading
+        // completions only stalls its own submit queue.
+        while (!mCompletionQueue->writeBlocking(&completion, 1, POLL_TIMEOUT_NS)) {
+            if (mStop) {
+                ALOGW("session closed, dropped completion of job %u", job.cookie);
+                break;
+            }
+        }
+    }
+}
+
+int32_t SbwcDecompSession::run(const SessionJob &job)
+{
+    ATRACE_CALL();
+
+    Buffer src = buffer(job.srcIndex);
+    Buffer dst = buffer(job.dstIndex);
+    if (!src || !dst)
+        return android::BAD_VALUE;
+
+    return mService->runSessionJob(src.get(), dst.get(), job);
+}
+
+SbwcDecompSession::Buffer SbwcDecompSession::buffer(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mBuffersLock);
+
+    return index < mBuffers.size() ? mBuffers[index] : nullptr;
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,100 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECOMPSESSION_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECOMPSESSION_H
+
+#include <vendor/samsung_slsi/hardware/SbwcDecompService/1.1/ISbwcDecompSession.h>
+#include <fmq/MessageQueue.h>
+#include <hidl/Status.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+struct SbwcDecompService;
+
+using ::android::hardware::hidl_handle;
+using ::android::hardware::hidl_vec;
+using ::android::hardware::Return;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::SessionCompletion;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::SessionJob;
+
+/*
+ * One client session. Jobs are read from the submit queue by a thread of
+ * the session and decoded in order on the buffers registered up front.
+ * The service must have reserved a session with acquireSession(), close()
+ * gives it back.
+ */
+struct SbwcDecompSession : public V1_1::ISbwcDecompSession {
+    explicit SbwcDecompSession(SbwcDecompService *service);
+    ~SbwcDecompSession();
+
+    bool valid() const { return mThread.joinable(); }
+
+    // Methods from ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ISbwcDecompSession follow.
+    Return<void> registerBuffers(const hidl_vec<hidl_handle> &buffers, registerBuffers_cb _hidl_cb) override;
+    Return<int32_t> unregisterBuffers(const hidl_vec<uint32_t> &indices) override;
+    Return<void> getQueues(getQueues_cb _hidl_cb) override;
+    Return<void> close() override;
+
+private:
+    using SubmitQueue = ::android::hardware::MessageQueue<SessionJob, ::android::hardware::kSynchronizedReadWrite>;
+    using CompletionQueue = ::android::hardware::MessageQueue<SessionCompletion, ::android::hardware::kSynchronizedReadWrite>;
+    using Buffer = std::shared_ptr<native_handle_t>;
+
+    void threadLoop();
+    int32_t run(const SessionJob &job);
+    Buffer buffer(uint32_t index);
+
+    static constexpr size_t QUEUE_SIZE = 16;
+    static constexpr size_t MAX_BUFFERS = 64;
+    // How often the session thread looks at mStop while the queue is empty.
+    static constexpr int64_t POLL_TIMEOUT_NS = 100000000;
+
+    SbwcDecompService *mService;
+
+    std::unique_ptr<SubmitQueue> mSubmitQueue;
+    std::unique_ptr<CompletionQueue> mCompletionQueue;
+
+    std::mutex mBuffersLock;
+    std::vector<Buffer> mBuffers;       // indexed by buffer index, empty slots are free
+
+    std::mutex mCloseLock;
+    bool mClosed;
+
+    std::atomic<bool> mStop;
+    std::thread mThread;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+
+#include "SbwcDecompStats.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+namespace {
+
+const char *methodNames[] = { "decode", "decodeAsync", "decodeBatch", "decodeWithRegion", "decodeWithScale", "session" };
+const char *phaseNames[] = { "queue", "pool", "decode", "total" };
+const char *resolutionNames[] = { "<=FHD", "<=UHD", ">UHD" };
+
+}  // namespace
+
+void SbwcDecompStats::Histogram::add(uint64_t us)
+{
+    size_t bucket = 0;
+    while (bucket < BUCKETS - 1 && us >= (1ull << bucket))
+        bucket++;
+
+    count[bucket]++;
+    total++;
+    sumUs += us;
+    maxUs = std::max(maxUs, us);
+}
+
+uint64_t SbwcDecompStats::Histogram::percentile(uint32_t pct) const
+{
+    uint64_t rank = (total * pct + 99) / 100;
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < BUCKETS - 1; bucket++) {
+        seen += count[bucket];
+        if (seen >= rank)
+            return std::min<uint64_t>(maxUs, 1ull << bucket);
+    }
+
+    return maxUs;
+}
+
+int SbwcDecompStats::resolutionClass(uint64_t pixels)
+{
+    if (pixels <= 1920 * 1088)
+        return 0;
+    if (pixels <= 3840 * 2176)
+        return 1;
+    return 2;
+}
+
+void SbwcDecompStats::record(Sample &sample, int32_t error)
+{
+    sample.phase[PHASE_TOTAL] = Clock::now() - sample.start;
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    MethodCounters &counters = mMethods[sample.method];
+    counters.calls++;
+    if (error == -EBUSY)
+        counters.busy++;
+    else if (error != 0)
+        counters.failures++;
+
+    // Only completed decodes go to the histograms.
+    if (error != 0)
+        return;
+
+    int resolution = resolutionClass(sample.pixels);
+    Entry &entry = mEntries[std::make_pair(resolution, sample.attr)];
+    entry.pixels += sample.pixels;
+    for (size_t i = 0; i < PHASE_COUNT; i++)
+        entry.phase[i].add(std::chrono::duration_cast<std::chrono::microseconds>(sample.phase[i]).count());
+
+    mLoad[resolution][sample.contended].add(
+            std::chrono::duration_cast<std::chrono::microseconds>(sample.phase[PHASE_TOTAL]).count());
+}
+
+void SbwcDecompStats::dump(int fd)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    dprintf(fd, "Calls:\n");
+    for (size_t i = 0; i < METHOD_COUNT; i++) {
+        const MethodCounters &counters = mMethods[i];
+        dprintf(fd, "  %-18s calls %" PRIu64 ", failures %" PRIu64 ", busy %" PRIu64 "\n",
+                methodNames[i], counters.calls, counters.failures, counters.busy);
+    }
+
+    dprintf(fd, "Latency in us (count avg p50 p99 max):\n");
+    for (auto &it : mEntries) {
+        const Entry &entry = it.second;
+        dprintf(fd, "  %s attr 0x%x, %" PRIu64 " Mpixels\n", resolutionNames[it.first.first], it.first.second,
+                entry.pixels / 1000000);
+
+        for (size_t i = 0; i < PHASE_COUNT; i++) {
+            const Histogram &histogram = entry.phase[i];
+            dprintf(fd, "    %-6s %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", phaseNames[i],
+                    histogram.total, histogram.total ? histogram.sumUs / histogram.total : 0,
+                    histogram.percentile(50), histogram.percentile(99), histogram.maxUs);
+        }
+    }
+
+    dprintf(fd, "Total latency by load in us (count p50 p99 max):\n");
+    for (int i = 0; i < RESOLUTION_CLASSES; i++) {
+        const Histogram &alone = mLoad[i][0];
+        const Histogram &contended = mLoad[i][1];
+        dprintf(fd, "  %-6s alone %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 ", contended %" PRIu64 " %" PRIu64
+                " %" PRIu64 " %" PRIu64 "\n", resolutionNames[i],
+                alone.total, alone.percentile(50), alone.percentile(99), alone.maxUs,
+                contended.total, contended.percentile(50), contended.percentile(99), contended.maxUs);
+    }
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,119 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECOMPSTATS_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCDECOMPSTATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Counters and latency histograms of every decode, shown by lshal debug.
+ * Histograms are kept per output resolution class and attr. Total latency
+ * is also kept per resolution class, split by whether other decodes were
+ * pending when the call was admitted, to show the tail under mixed load.
+ */
+class SbwcDecompStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Method {
+        METHOD_DECODE,
+        METHOD_ASYNC,
+        METHOD_BATCH,
+        METHOD_REGION,
+        METHOD_SCALE,
+        METHOD_SESSION,
+        METHOD_COUNT,
+    };
+
+    enum Phase {
+        PHASE_QUEUE,    // posted to a worker until picked up
+        PHASE_POOL,     // waiting for a decoder instance
+        PHASE_DECODE,   // inside SbwcWrapper::decode
+        PHASE_TOTAL,    // whole call, including the CPU passes
+        PHASE_COUNT,
+    };
+
+    // Filled in along the way of one call and handed to record() at the end.
+    struct Sample {
+        Sample(Method method, uint32_t attr) : method(method), attr(attr), start(Clock::now()) {}
+
+        Method method;
+        uint32_t attr;
+        uint64_t pixels = 0;
+        bool contended = false;     // other decodes were pending at admission
+        Clock::time_point start;
+        Clock::duration phase[PHASE_COUNT] = {};
+    };
+
+    void record(Sample &sample, int32_t error);
+    void dump(int fd);
+
+private:
+    // Power of two buckets in microseconds, the last one is open ended.
+    static constexpr size_t BUCKETS = 20;
+
+    struct Histogram {
+        uint64_t count[BUCKETS] = {};
+        uint64_t total = 0;
+        uint64_t sumUs = 0;
+        uint64_t maxUs = 0;
+
+        void add(uint64_t us);
+        uint64_t percentile(uint32_t pct) const;
+    };
+
+    struct Entry {
+        Histogram phase[PHASE_COUNT];
+        uint64_t pixels = 0;
+    };
+
+    struct MethodCounters {
+        uint64_t calls = 0;
+        uint64_t failures = 0;
+        uint64_t busy = 0;
+    };
+
+    static constexpr int RESOLUTION_CLASSES = 3;
+
+    static int resolutionClass(uint64_t pixels);
+
+    std::mutex mLock;
+    MethodCounters mMethods[METHOD_COUNT];
+    std::map<std::pair<int, uint32_t>, Entry> mEntries;     // (resolution class, attr)
+    Histogram mLoad[RESOLUTION_CLASSES][2];                  // total, by resolution class and contended
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "SbwcDecompService"
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+#include <log/log.h>
+#include <sync/sync.h>
+#include "SbwcFence.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+bool waitAndCloseFence(int fenceFd, int timeoutMs)
+{
+    if (fenceFd < 0)
+        return true;
+
+    int ret = sync_wait(fenceFd, timeoutMs);
+    if (ret < 0)
+        ALOGE("failed to wait acquire fence %d: %s", fenceFd, strerror(errno));
+
+    close(fenceFd);
+
+    return ret >= 0;
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
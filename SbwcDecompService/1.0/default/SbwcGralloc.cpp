@@ -0,0 +1,97 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <new>
+
+#include <ui/GraphicBufferMapper.h>
+#include <ui/Rect.h>
+#include <ExynosGraphicBuffer.h>
+#include "SbwcGralloc.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::GraphicBufferMapper;
+using ::vendor::graphics::ExynosGraphicBufferMeta;
+
+namespace {
+
+class ExynosGralloc : public SbwcGralloc {
+public:
+    uint64_t getBufferId(const native_handle_t *handle) override
+    {
+        return ExynosGraphicBufferMeta::get_buffer_id(handle);
+    }
+
+    bool getInfo(const native_handle_t *handle, SbwcBufferInfo &info) override
+    {
+        info.bufferId = ExynosGraphicBufferMeta::get_buffer_id(handle);
+        info.width = static_cast<uint32_t>(ExynosGraphicBufferMeta::get_width(handle));
+        info.height = static_cast<uint32_t>(ExynosGraphicBufferMeta::get_height(handle));
+        info.format = ExynosGraphicBufferMeta::get_format(handle);
+        info.stride = ExynosGraphicBufferMeta::get_stride(handle);
+        info.vstride = ExynosGraphicBufferMeta::get_vstride(handle);
+
+        return true;
+    }
+
+    buffer_handle_t importBuffer(const native_handle_t *handle, const SbwcBufferInfo &info, uint32_t usage) override
+    {
+        buffer_handle_t imported = nullptr;
+
+        if (GraphicBufferMapper::get().importBuffer(handle, info.width, info.height, 1, info.format, usage,
+                                                    info.stride, &imported) != android::NO_ERROR)
+            return nullptr;
+
+        return imported;
+    }
+
+    void freeBuffer(buffer_handle_t imported) override
+    {
+        GraphicBufferMapper::get().freeBuffer(imported);
+    }
+
+    bool lockYCbCr(buffer_handle_t imported, uint32_t usage, uint32_t width, uint32_t height,
+                   android_ycbcr &ycbcr) override
+    {
+        return GraphicBufferMapper::get().lockYCbCr(imported, usage, android::Rect(width, height),
+                                                    &ycbcr) == android::NO_ERROR;
+    }
+
+    void unlock(buffer_handle_t imported) override
+    {
+        GraphicBufferMapper::get().unlock(imported);
+    }
+};
+
+}  // namespace
+
+std::shared_ptr<SbwcGralloc> SbwcGralloc::createDefault()
+{
+    return std::shared_ptr<SbwcGralloc>(new (std::nothrow) ExynosGralloc());
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,74 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCGRALLOC_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCGRALLOC_H
+
+#include <cstdint>
+#include <memory>
+
+#include <cutils/native_handle.h>
+#include <system/graphics.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+struct SbwcBufferInfo {
+    uint64_t bufferId;      // assigned by gralloc, never reused for another allocation
+    uint32_t width;
+    uint32_t height;
+    int format;
+    uint32_t stride;
+    uint32_t vstride;
+};
+
+/*
+ * Gralloc calls the service makes on client buffers. As with SbwcDecoder,
+ * the service can be given fake buffers to run without a device.
+ */
+class SbwcGralloc {
+public:
+    virtual ~SbwcGralloc() {}
+
+    virtual uint64_t getBufferId(const native_handle_t *handle) = 0;
+    // Fills every field of info, bufferId included.
+    virtual bool getInfo(const native_handle_t *handle, SbwcBufferInfo &info) = 0;
+
+    // Returns the imported handle, or nullptr on failure.
+    virtual buffer_handle_t importBuffer(const native_handle_t *handle, const SbwcBufferInfo &info, uint32_t usage) = 0;
+    virtual void freeBuffer(buffer_handle_t imported) = 0;
+
+    virtual bool lockYCbCr(buffer_handle_t imported, uint32_t usage, uint32_t width, uint32_t height,
+                           android_ycbcr &ycbcr) = 0;
+    virtual void unlock(buffer_handle_t imported) = 0;
+
+    // Exynos gralloc through GraphicBufferMapper.
+    static std::shared_ptr<SbwcGralloc> createDefault();
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "SbwcDecompService"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <vector>
+
+#include <log/log.h>
+#include "SbwcImage.h"
+#include "SbwcKernels.h"
+
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+#include <utils/Trace.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::GraphicBuffer;
+
+namespace {
+
+constexpr uint32_t MIN_STRIPE_ROWS = 16;
+
+size_t bytesPerSample(const SbwcImage &image)
+{
+    return image.chromaStep == 4 ? 2 : 1;
+}
+
+bool sameLayout(const SbwcImage &lhs, const SbwcImage &rhs)
+{
+    return lhs.chromaStep == rhs.chromaStep && (lhs.cb < lhs.cr) == (rhs.cb < rhs.cr);
+}
+
+void copyPlane(uint8_t *dst, size_t dstStride, const uint8_t *src, size_t srcStride, size_t rowBytes, uint32_t rows)
+{
+    for (uint32_t row = 0; row < rows; row++)
+        memcpy(dst + row * dstStride, src + row * srcStride, rowBytes);
+}
+
+// step is the distance between samples of one channel, in samples.
+template <typename T>
+void boxPlane(uint8_t *dst, size_t dstStride, size_t dstStep,
+              const uint8_t *src, size_t srcStride, size_t srcStep,
+              uint32_t width, uint32_t begin, uint32_t end, uint32_t shift, T mask)
+{
+    if (sizeof(T) == 1 && shift == 1 && srcStep == 1 && dstStep == 1) {
+        for (uint32_t row = begin; row < end; row++)
+            boxRow2x2(src + row * 2 * srcStride, src + (row * 2 + 1) * srcStride, dst + row * dstStride, width);
+        return;
+    }
+
+    const uint32_t factor = 1u << shift;
+    const uint32_t round = (1u << (shift * 2)) >> 1;
+    std::vector<uint32_t> sums(width);
+
+    for (uint32_t row = begin; row < end; row++) {
+        std::fill(sums.begin(), sums.end(), 0);
+
+        for (uint32_t i = 0; i < factor; i++) {
+            auto in = reinterpret_cast<const T *>(src + (row * factor + i) * srcStride);
+            for (uint32_t col = 0; col < width; col++) {
+                const T *block = in + col * factor * srcStep;
+                uint32_t sum = 0;
+                for (uint32_t j = 0; j < factor; j++)
+                    sum += block[j * srcStep];
+                sums[col] += sum;
+            }
+        }
+
+        auto out = reinterpret_cast<T *>(dst + row * dstStride);
+        for (uint32_t col = 0; col < width; col++)
+            out[col * dstStep] = static_cast<T>((sums[col] + round) >> (shift * 2)) & mask;
+    }
+}
+
+// Stripes are counted in chroma rows so that each one covers whole 4:2:0 blocks.
+template <typename T>
+void boxImage(const SbwcImage &src, const SbwcImage &dst, uint32_t width, uint32_t height, uint32_t shift, T mask,
+              SbwcStripeRunner *runner)
+{
+    size_t srcStep = src.chromaStep / sizeof(T);
+    size_t dstStep = dst.chromaStep / sizeof(T);
+
+    auto stripe = [&](uint32_t begin, uint32_t end) {
+        boxPlane<T>(dst.y, dst.yStride, 1, src.y, src.yStride, 1, width, begin * 2, end * 2, shift, mask);
+        boxPlane<T>(dst.cb, dst.cStride, dstStep, src.cb, src.cStride, srcStep, width / 2, begin, end, shift, mask);
+        boxPlane<T>(dst.cr, dst.cStride, dstStep, src.cr, src.cStride, srcStep, width / 2, begin, end, shift, mask);
+    };
+
+    if (runner)
+        runner->run(height / 2, MIN_STRIPE_ROWS, stripe);
+    else
+        stripe(0, height / 2);
+}
+
+}  // namespace
+
+SbwcLockedImage::SbwcLockedImage(const std::shared_ptr<SbwcImportedBuffer> &buffer, const SbwcBufferInfo &info,
+                                 uint32_t usage)
+    : mImported(buffer), mLocked(false)
+{
+    android_ycbcr ycbcr;
+
+    if (!mImported)
+        return;
+
+    if (!mImported->gralloc().lockYCbCr(mImported->handle(), usage, info.width, info.height, ycbcr)) {
+        ALOGE("failed to lock %ux%u buffer %" PRIu64, info.width, info.height, info.bufferId);
+        return;
+    }
+
+    setImage(ycbcr, info.width, info.height);
+}
+
+SbwcLockedImage::SbwcLockedImage(const android::sp<GraphicBuffer> &buffer, uint32_t usage)
+    : mBuffer(buffer), mLocked(false)
+{
+    android_ycbcr ycbcr;
+
+    if (buffer->lockYCbCr(usage, &ycbcr) != android::NO_ERROR) {
+        ALOGE("failed to lock %ux%u scratch buffer", buffer->getWidth(), buffer->getHeight());
+        return;
+    }
+
+    setImage(ycbcr, buffer->getWidth(), buffer->getHeight());
+}
+
+SbwcLockedImage::~SbwcLockedImage()
+{
+    if (!mLocked)
+        return;
+
+    if (mBuffer != nullptr)
+        mBuffer->unlock();
+    else
+        mImported->gralloc().unlock(mImported->handle());
+}
+
+void SbwcLockedImage::setImage(const android_ycbcr &ycbcr, uint32_t width, uint32_t height)
+{
+    mImage.y = static_cast<uint8_t *>(ycbcr.y);
+    mImage.cb = static_cast<uint8_t *>(ycbcr.cb);
+    mImage.cr = static_cast<uint8_t *>(ycbcr.cr);
+    mImage.yStride = ycbcr.ystride;
+    mImage.cStride = ycbcr.cstride;
+    mImage.chromaStep = ycbcr.chroma_step;
+    mImage.width = width;
+    mImage.height = height;
+    mLocked = true;
+}
+
+bool copyRegion(const SbwcImage &src, uint32_t x, uint32_t y, const SbwcImage &dst, uint32_t width, uint32_t height)
+{
+    ATRACE_CALL();
+
+    if (!sameLayout(src, dst) || ((x | y | width | height) & 1))
+        return false;
+
+    if (x + width > src.width || y + height > src.height || width > dst.width || height > dst.height)
+        return false;
+
+    size_t bps = bytesPerSample(src);
+
+    copyPlane(dst.y, dst.yStride, src.y + y * src.yStride + x * bps, src.yStride, width * bps, height);
+
+    size_t cx = x / 2, cy = y / 2;
+    uint32_t cw = width / 2, ch = height / 2;
+
+    if (src.chromaStep > 1) {
+        // Interleaved chroma is copied as one plane starting at whichever of cb/cr comes first.
+        const uint8_t *srcC = std::min(src.cb, src.cr) + cy * src.cStride + cx * src.chromaStep;
+        uint8_t *dstC = std::min(dst.cb, dst.cr);
+        copyPlane(dstC, dst.cStride, srcC, src.cStride, cw * src.chromaStep, ch);
+    } else {
+        copyPlane(dst.cb, dst.cStride, src.cb + cy * src.cStride + cx, src.cStride, cw, ch);
+        copyPlane(dst.cr, dst.cStride, src.cr + cy * src.cStride + cx, src.cStride, cw, ch);
+    }
+
+    return true;
+}
+
+bool boxDownscale(const SbwcImage &src, const SbwcImage &dst, uint32_t shift, SbwcStripeRunner *runner)
+{
+    ATRACE_CALL();
+
+    uint32_t width = src.width >> shift;
+    uint32_t height = src.height >> shift;
+
+    if (!sameLayout(src, dst) || width == 0 || height == 0 || ((width | height) & 1))
+        return false;
+
+    if (width > dst.width || height > dst.height)
+        return false;
+
+    if (bytesPerSample(src) == 2)
+        // P010 keeps 10 significant bits at the top, clear what averaging leaves below them.
+        boxImage<uint16_t>(src, dst, width, height, shift, 0xffc0, runner);
+    else
+        boxImage<uint8_t>(src, dst, width, height, shift, 0xff, runner);
+
+    return true;
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
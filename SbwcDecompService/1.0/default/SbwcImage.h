@@ -0,0 +1,92 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCIMAGE_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCIMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <ui/GraphicBuffer.h>
+#include <cutils/native_handle.h>
+
+#include "SbwcBufferCache.h"
+#include "SbwcStripeRunner.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * CPU view of a decoded YCbCr 4:2:0 image, as returned by gralloc.
+ * chromaStep is 1 for planar, 2 for 8-bit semi-planar and 4 for P010.
+ */
+struct SbwcImage {
+    uint8_t *y;
+    uint8_t *cb;
+    uint8_t *cr;
+    size_t yStride;
+    size_t cStride;
+    size_t chromaStep;
+    uint32_t width;
+    uint32_t height;
+};
+
+/*
+ * Keeps a buffer CPU locked for as long as the object lives.
+ */
+class SbwcLockedImage {
+public:
+    SbwcLockedImage(const std::shared_ptr<SbwcImportedBuffer> &buffer, const SbwcBufferInfo &info, uint32_t usage);
+    SbwcLockedImage(const android::sp<android::GraphicBuffer> &buffer, uint32_t usage);
+    ~SbwcLockedImage();
+
+    SbwcLockedImage(const SbwcLockedImage &) = delete;
+    SbwcLockedImage &operator=(const SbwcLockedImage &) = delete;
+
+    bool valid() const { return mLocked; }
+    const SbwcImage &image() const { return mImage; }
+
+private:
+    void setImage(const android_ycbcr &ycbcr, uint32_t width, uint32_t height);
+
+    std::shared_ptr<SbwcImportedBuffer> mImported;
+    android::sp<android::GraphicBuffer> mBuffer;
+    bool mLocked;
+    SbwcImage mImage;
+};
+
+// Copies the width x height region at (x, y) of src to the origin of dst.
+bool copyRegion(const SbwcImage &src, uint32_t x, uint32_t y, const SbwcImage &dst, uint32_t width, uint32_t height);
+
+// Box filters src by 2^shift in each direction to the origin of dst,
+// split over runner when one is given. Without a runner src may be the
+// same image as dst.
+bool boxDownscale(const SbwcImage &src, const SbwcImage &dst, uint32_t shift, SbwcStripeRunner *runner = nullptr);
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "SbwcKernels.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+void boxRow2x2(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, uint32_t width)
+{
+    uint32_t col = 0;
+
+#if defined(__ARM_NEON)
+    for (; col + 16 <= width; col += 16) {
+        uint16x8_t lo = vaddq_u16(vpaddlq_u8(vld1q_u8(row0 + col * 2)), vpaddlq_u8(vld1q_u8(row1 + col * 2)));
+        uint16x8_t hi = vaddq_u16(vpaddlq_u8(vld1q_u8(row0 + col * 2 + 16)), vpaddlq_u8(vld1q_u8(row1 + col * 2 + 16)));
+        vst1q_u8(dst + col, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+#elif defined(__SSE2__)
+    const __m128i even = _mm_set1_epi16(0x00ff);
+    const __m128i round = _mm_set1_epi16(2);
+
+    auto sum = [&](const uint8_t *p0, const uint8_t *p1) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p0));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p1));
+        __m128i s = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, even), _mm_srli_epi16(a, 8)),
+                                  _mm_add_epi16(_mm_and_si128(b, even), _mm_srli_epi16(b, 8)));
+        return _mm_srli_epi16(_mm_add_epi16(s, round), 2);
+    };
+
+    for (; col + 16 <= width; col += 16) {
+        __m128i lo = sum(row0 + col * 2, row1 + col * 2);
+        __m128i hi = sum(row0 + col * 2 + 16, row1 + col * 2 + 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + col), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; col < width; col++)
+        dst[col] = static_cast<uint8_t>((row0[col * 2] + row0[col * 2 + 1] + row1[col * 2] + row1[col * 2 + 1] + 2) >> 2);
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,256 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "SbwcDecompService"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+#include <cutils/properties.h>
+#include <log/log.h>
+#include <hardware/gralloc.h>
+#include "SbwcImage.h"
+#include "SbwcOutputCache.h"
+
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+#include <utils/Trace.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+SbwcOutputCache::Entry::~Entry()
+{
+    native_handle_close(dstBH);
+    native_handle_delete(dstBH);
+}
+
+SbwcOutputCache::SbwcOutputCache(SbwcBufferCache &buffers)
+    : mBuffers(buffers),
+      mEnabled(property_get_bool("persist.vendor.sbwc.output_cache", false)),
+      mTtl(std::max(1, property_get_int32("ro.vendor.sbwc.output_cache_ttl_ms", 16))),
+      mHits(0), mMisses(0), mAliased(0), mBytesSaved(0)
+{
+    if (mEnabled)
+        mExpiryThread = std::thread(&SbwcOutputCache::expiryLoop, this);
+}
+
+SbwcOutputCache::~SbwcOutputCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mExpiryCond.notify_all();
+
+    if (mExpiryThread.joinable())
+        mExpiryThread.join();
+}
+
+bool SbwcOutputCache::reuse(const SbwcBufferInfo &src, const SbwcBufferInfo &dst, const native_handle_t *dstBH,
+                            uint32_t attr, uint32_t cropWidth, uint32_t cropHeight)
+{
+    std::shared_ptr<Entry> entry;
+    std::list<std::shared_ptr<Entry>> expired;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        expireLocked(std::chrono::steady_clock::now(), expired);
+
+        auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](const std::shared_ptr<Entry> &e) {
+            return e->srcId == src.bufferId &&
+                   e->attr == attr && e->cropWidth == cropWidth && e->cropHeight == cropHeight &&
+                   e->dst.width == dst.width && e->dst.height == dst.height && e->dst.format == dst.format;
+        });
+
+        if (it == mEntries.end()) {
+            mMisses++;
+            return false;
+        }
+
+        entry = *it;
+    }
+
+    uint64_t frameBytes = static_cast<uint64_t>(dst.stride) * dst.vstride * 3 / 2;
+
+    if (entry->dst.bufferId == dst.bufferId) {
+        mHits++;
+        mAliased++;
+        mBytesSaved += frameBytes;
+        return true;
+    }
+
+    std::shared_lock<std::shared_mutex> inUse(entry->inUse);
+
+    // Invalidated while we were waiting for it.
+    if (entry->invalidated) {
+        mMisses++;
+        return false;
+    }
+
+    // Only the crop was decoded there, and only the crop may be written here.
+    bool copied = false;
+    {
+        ATRACE_NAME("copyCrop");
+
+        SbwcLockedImage from(mBuffers.import(entry->dstBH, entry->dst, GRALLOC_USAGE_SW_READ_OFTEN), entry->dst,
+                             GRALLOC_USAGE_SW_READ_OFTEN);
+        SbwcLockedImage to(mBuffers.import(dstBH, dst, GRALLOC_USAGE_SW_WRITE_OFTEN), dst,
+                           GRALLOC_USAGE_SW_WRITE_OFTEN);
+
+        copied = from.valid() && to.valid() && copyRegion(from.image(), 0, 0, to.image(), cropWidth, cropHeight);
+    }
+
+    if (!copied) {
+        mMisses++;
+        return false;
+    }
+
+    mHits++;
+    mBytesSaved += static_cast<uint64_t>(cropWidth) * cropHeight * 3 / 2;
+
+    return true;
+}
+
+void SbwcOutputCache::invalidate(const SbwcBufferInfo &dst)
+{
+    std::list<std::shared_ptr<Entry>> removed;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        for (auto it = mEntries.begin(); it != mEntries.end();) {
+            if ((*it)->dst.bufferId == dst.bufferId)
+                removed.splice(removed.end(), mEntries, it++);
+            else
+                ++it;
+        }
+    }
+
+    // Wait for copies still reading from the buffer about to be overwritten.
+    for (auto &entry : removed) {
+        std::unique_lock<std::shared_mutex> inUse(entry->inUse);
+        entry->invalidated = true;
+    }
+}
+
+void SbwcOutputCache::store(const SbwcBufferInfo &src, const SbwcBufferInfo &dst, const native_handle_t *dstBH,
+                            uint32_t attr, uint32_t cropWidth, uint32_t cropHeight)
+{
+    native_handle_t *clone = native_handle_clone(dstBH);
+    if (!clone)
+        return;
+
+    auto entry = std::make_shared<Entry>();
+    entry->srcId = src.bufferId;
+    entry->attr = attr;
+    entry->cropWidth = cropWidth;
+    entry->cropHeight = cropHeight;
+    entry->dst = dst;
+    entry->dstBH = clone;
+    entry->stored = std::chrono::steady_clock::now();
+    entry->invalidated = false;
+
+    std::shared_ptr<Entry> evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        bool wasEmpty = mEntries.empty();
+        mEntries.push_front(std::move(entry));
+        if (mEntries.size() > MAX_ENTRIES) {
+            evicted = std::move(mEntries.back());
+            mEntries.pop_back();
+        }
+
+        if (!wasEmpty)
+            return;
+    }
+
+    // The timer only sleeps without a deadline while the cache is empty.
+    mExpiryCond.notify_all();
+}
+
+void SbwcOutputCache::clear()
+{
+    std::list<std::shared_ptr<Entry>> entries;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        entries.swap(mEntries);
+    }
+}
+
+void SbwcOutputCache::dump(int fd) const
+{
+    uint64_t hits = mHits, misses = mMisses;
+    uint64_t lookups = hits + misses;
+
+    dprintf(fd, "Output cache: %s, ttl %lld ms\n", mEnabled ? "enabled" : "disabled",
+            static_cast<long long>(mTtl.count()));
+    dprintf(fd, "  hits %" PRIu64 " (aliased %" PRIu64 "), misses %" PRIu64 ", hit rate %.1f%%\n",
+            hits, mAliased.load(), misses, lookups ? 100.0 * hits / lookups : 0.0);
+    dprintf(fd, "  bytes saved %" PRIu64 "\n", mBytesSaved.load());
+}
+
+void SbwcOutputCache::expireLocked(std::chrono::steady_clock::time_point now,
+                                   std::list<std::shared_ptr<Entry>> &expired)
+{
+    while (!mEntries.empty() && now - mEntries.back()->stored > mTtl)
+        expired.splice(expired.begin(), mEntries, std::prev(mEntries.end()));
+}
+
+void SbwcOutputCache::expiryLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (!mStop) {
+        if (mEntries.empty()) {
+            mExpiryCond.wait(lock);
+            continue;
+        }
+
+        auto deadline = mEntries.back()->stored + mTtl;
+        if (std::chrono::steady_clock::now() <= deadline) {
+            mExpiryCond.wait_until(lock, deadline + std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // Entries close their clones, which is done without the lock.
+        std::list<std::shared_ptr<Entry>> expired;
+        expireLocked(std::chrono::steady_clock::now(), expired);
+
+        lock.unlock();
+        expired.clear();
+        lock.lock();
+    }
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
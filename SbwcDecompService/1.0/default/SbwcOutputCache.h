@@ -0,0 +1,120 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCOUTPUTCACHE_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCOUTPUTCACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include <cutils/native_handle.h>
+
+#include "SbwcBufferCache.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Remembers the destination of recent decodes so that the same source,
+ * attr and crop decoded again within a short window is served from the
+ * previous output: nothing is done when the destination is the same
+ * buffer, otherwise the crop of the previous output is copied and the
+ * rest of the destination is left alone.
+ *
+ * The service cannot see CPU or GPU writes to a source, so the cache is
+ * opt-in through persist.vendor.sbwc.output_cache and entries expire
+ * after ro.vendor.sbwc.output_cache_ttl_ms. Expired entries are dropped
+ * by a timer thread, so their destination clones are not kept alive by
+ * a client that stopped decoding.
+ */
+class SbwcOutputCache {
+public:
+    // Copies go through the imports of buffers.
+    explicit SbwcOutputCache(SbwcBufferCache &buffers);
+    ~SbwcOutputCache();
+
+    bool enabled() const { return mEnabled; }
+
+    // Returns true when dst now holds the result of the request.
+    bool reuse(const SbwcBufferInfo &src, const SbwcBufferInfo &dst, const native_handle_t *dstBH,
+               uint32_t attr, uint32_t cropWidth, uint32_t cropHeight);
+    // Called before dst is written so that no entry keeps pointing at it.
+    void invalidate(const SbwcBufferInfo &dst);
+    void store(const SbwcBufferInfo &src, const SbwcBufferInfo &dst, const native_handle_t *dstBH,
+               uint32_t attr, uint32_t cropWidth, uint32_t cropHeight);
+
+    // Drops every entry, for when the service goes idle.
+    void clear();
+
+    void dump(int fd) const;
+
+private:
+    struct Entry {
+        ~Entry();
+
+        uint64_t srcId;
+        uint32_t attr;
+        uint32_t cropWidth;
+        uint32_t cropHeight;
+        SbwcBufferInfo dst;
+        native_handle_t *dstBH;
+        std::chrono::steady_clock::time_point stored;
+        // Held shared while the entry is copied from, exclusively on invalidation.
+        std::shared_mutex inUse;
+        bool invalidated;
+    };
+
+    void expireLocked(std::chrono::steady_clock::time_point now, std::list<std::shared_ptr<Entry>> &expired);
+    void expiryLoop();
+
+    static constexpr size_t MAX_ENTRIES = 4;
+
+    SbwcBufferCache &mBuffers;
+    const bool mEnabled;
+    const std::chrono::milliseconds mTtl;
+
+    std::mutex mLock;
+    std::list<std::shared_ptr<Entry>> mEntries;     // newest first
+
+    std::condition_variable mExpiryCond;
+    bool mStop = false;
+    std::thread mExpiryThread;
+
+    std::atomic<uint64_t> mHits;
+    std::atomic<uint64_t> mMisses;
+    std::atomic<uint64_t> mAliased;
+    std::atomic<uint64_t> mBytesSaved;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
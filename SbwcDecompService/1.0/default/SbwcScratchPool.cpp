@@ -0,0 +1,101 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "SbwcDecompService"
+
+#include <algorithm>
+
+#include <log/log.h>
+#include "SbwcScratchPool.h"
+
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+#include <utils/Trace.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::GraphicBuffer;
+using ::android::sp;
+
+SbwcScratchPool::SbwcScratchPool(size_t capacity)
+    : mCapacity(capacity)
+{
+}
+
+sp<GraphicBuffer> SbwcScratchPool::acquire(uint32_t width, uint32_t height, int format)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        auto it = std::find_if(mFree.rbegin(), mFree.rend(), [&](const sp<GraphicBuffer> &buffer) {
+            return buffer->getWidth() == width && buffer->getHeight() == height &&
+                   buffer->getPixelFormat() == format;
+        });
+
+        if (it != mFree.rend()) {
+            sp<GraphicBuffer> buffer = *it;
+            mFree.erase(std::next(it).base());
+            return buffer;
+        }
+    }
+
+    ATRACE_NAME("allocateScratch");
+
+    sp<GraphicBuffer> buffer = new GraphicBuffer(width, height, format, 1, USAGE, "SbwcDecompScratch");
+    if (buffer->initCheck() != android::NO_ERROR) {
+        ALOGE("failed to allocate %ux%u scratch buffer of format %#x", width, height, format);
+        return nullptr;
+    }
+
+    return buffer;
+}
+
+void SbwcScratchPool::release(const sp<GraphicBuffer> &buffer)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mFree.push_back(buffer);
+    if (mFree.size() > mCapacity)
+        mFree.erase(mFree.begin());
+}
+
+void SbwcScratchPool::clear()
+{
+    std::vector<sp<GraphicBuffer>> buffers;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        buffers.swap(mFree);
+    }
+
+    if (!buffers.empty())
+        ALOGD("releasing %zu scratch buffers", buffers.size());
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,64 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCSCRATCHPOOL_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCSCRATCHPOOL_H
+
+#include <mutex>
+#include <vector>
+
+#include <hardware/gralloc.h>
+#include <ui/GraphicBuffer.h>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Intermediate buffers for decodes that need a CPU pass before reaching
+ * the client buffer. Returned buffers are kept for reuse so that a
+ * steady stream of same-sized requests does not allocate.
+ */
+class SbwcScratchPool {
+public:
+    explicit SbwcScratchPool(size_t capacity);
+
+    android::sp<android::GraphicBuffer> acquire(uint32_t width, uint32_t height, int format);
+    void release(const android::sp<android::GraphicBuffer> &buffer);
+    // Frees the buffers kept for reuse. Buffers in use are kept again on release.
+    void clear();
+
+    static constexpr uint32_t USAGE = GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_HW_2D;
+
+private:
+    const size_t mCapacity;
+
+    std::mutex mLock;
+    std::vector<android::sp<android::GraphicBuffer>> mFree;     // oldest first
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include <cutils/properties.h>
+#include "SbwcStripeRunner.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+SbwcStripeRunner::SbwcStripeRunner(size_t threads)
+    : mStop(false)
+{
+    mThreads.reserve(threads);
+    for (size_t i = 0; i < threads; i++)
+        mThreads.emplace_back(&SbwcStripeRunner::threadLoop, this);
+}
+
+SbwcStripeRunner::~SbwcStripeRunner()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mCond.notify_all();
+
+    for (auto &thread : mThreads)
+        thread.join();
+}
+
+void SbwcStripeRunner::run(uint32_t count, uint32_t minStripe, const Function &fn)
+{
+    minStripe = std::max(1u, minStripe);
+
+    uint32_t stripes = std::min<uint32_t>(mThreads.size() + 1, (count + minStripe - 1) / minStripe);
+    if (stripes <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->fn = &fn;
+    batch->count = count;
+    batch->stripe = (count + stripes - 1) / stripes;
+    batch->stripes = stripes;
+    batch->next = 0;
+    batch->done = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mBatches.push_back(batch);
+    }
+    mCond.notify_all();
+
+    while (runStripe(*batch))
+        ;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        auto it = std::find(mBatches.begin(), mBatches.end(), batch);
+        if (it != mBatches.end())
+            mBatches.erase(it);
+    }
+
+    std::unique_lock<std::mutex> lock(batch->lock);
+    batch->cond.wait(lock, [&batch] { return batch->done.load() == batch->stripes; });
+}
+
+bool SbwcStripeRunner::runStripe(Batch &batch)
+{
+    uint32_t index = batch.next.fetch_add(1);
+    if (index >= batch.stripes)
+        return false;
+
+    uint32_t begin = index * batch.stripe;
+    (*batch.fn)(begin, std::min(batch.count, begin + batch.stripe));
+
+    if (batch.done.fetch_add(1) + 1 == batch.stripes) {
+        std::lock_guard<std::mutex> lock(batch.lock);
+        batch.cond.notify_all();
+    }
+
+    return true;
+}
+
+void SbwcStripeRunner::threadLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (true) {
+        mCond.wait(lock, [this] { return mStop || !mBatches.empty(); });
+
+        if (mStop)
+            return;
+
+        std::shared_ptr<Batch> batch = mBatches.front();
+        if (batch->next.load() >= batch->stripes) {
+            mBatches.pop_front();
+            continue;
+        }
+
+        lock.unlock();
+        runStripe(*batch);
+        lock.lock();
+    }
+}
+
+size_t SbwcStripeRunner::defaultThreads()
+{
+    int threads = property_get_int32("ro.vendor.sbwc.cpu_threads", -1);
+    if (threads >= 0)
+        return static_cast<size_t>(threads);
+
+    return std::min(3u, std::max(1u, std::thread::hardware_concurrency()) - 1);
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
@@ -0,0 +1,86 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCSTRIPERUNNER_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCSTRIPERUNNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Splits a CPU pass over image rows into stripes run by helper threads.
+ * The calling thread works on its own stripes too, so a pass never waits
+ * for a helper to become free and callers on worker threads cannot
+ * deadlock each other.
+ */
+class SbwcStripeRunner {
+public:
+    using Function = std::function<void(uint32_t begin, uint32_t end)>;
+
+    explicit SbwcStripeRunner(size_t threads);
+    ~SbwcStripeRunner();
+
+    // Calls fn over [0, count) in stripes of at least minStripe and returns once all have run.
+    void run(uint32_t count, uint32_t minStripe, const Function &fn);
+
+    // Helper count from ro.vendor.sbwc.cpu_threads, or one less than the cores up to 3.
+    static size_t defaultThreads();
+
+private:
+    struct Batch {
+        const Function *fn;
+        uint32_t count;
+        uint32_t stripe;
+        uint32_t stripes;
+        std::atomic<uint32_t> next;
+        std::atomic<uint32_t> done;
+        std::mutex lock;
+        std::condition_variable cond;
+    };
+
+    static bool runStripe(Batch &batch);
+    void threadLoop();
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::deque<std::shared_ptr<Batch>> mBatches;
+    std::vector<std::thread> mThreads;
+    bool mStop;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -20,20 +20,25 @@
 #endif
 #define LOG_TAG "SbwcDecompService"
 
+#include <algorithm>
+
 #include <android/log.h>
+#include <cutils/properties.h>
 #include <hidl/HidlTransportSupport.h>
 #include "SbwcDecompService.h"
 
-using vendor::samsung_slsi::hardware::SbwcDecompService::V1_0::ISbwcDecompService;
+using vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ISbwcDecompService;
 using vendor::samsung_slsi::hardware::SbwcDecompService::V1_0::implementation::SbwcDecompService;
 
 int main() {
     int res;
 
-    ALOGD("SbwcDecompService start");
+    int maxThreads = SbwcDecompService::defaultRpcThreads();
+
+    ALOGD("SbwcDecompService start with %d threads", maxThreads);
 
     android::hardware::configureRpcThreadpool(
-    1 /* maxThreads */,
+    maxThreads /* maxThreads */,
     true /* callerWillJoin */
     );
 
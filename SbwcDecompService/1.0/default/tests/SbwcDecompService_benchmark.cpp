@@ -0,0 +1,195 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SbwcDecompService.h"
+#include "SbwcFakeGralloc.h"
+#include "SbwcSimulatedDecoder.h"
+
+using namespace ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_0::implementation;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Resolution {
+    const char *name;
+    uint32_t width;
+    uint32_t height;
+    std::chrono::microseconds latency;
+};
+
+// About what the hardware takes for one 1080p frame, scaled by pixel count.
+constexpr Resolution RESOLUTIONS[] = {
+    { "1080p", 1920, 1088, std::chrono::microseconds(2000) },
+    { "4K", 3840, 2160, std::chrono::microseconds(8000) },
+    { "8K", 7680, 4320, std::chrono::microseconds(32000) },
+};
+constexpr int RESOLUTION_COUNT = sizeof(RESOLUTIONS) / sizeof(RESOLUTIONS[0]);
+
+// Call latencies in microseconds, from the first attempt to the result,
+// pooled over the threads of one run.
+class LatencyRecorder {
+public:
+    void add(Clock::duration latency)
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mUs.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    }
+
+    // Called by one thread once every thread has left the timed loop.
+    void report(benchmark::State &state, std::chrono::microseconds decodeLatency)
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mUs.empty())
+            return;
+
+        std::sort(mUs.begin(), mUs.end());
+
+        double sum = 0;
+        for (int64_t us : mUs)
+            sum += us;
+
+        state.counters["p50_us"] = mUs[mUs.size() / 2];
+        state.counters["p99_us"] = mUs[(mUs.size() - 1) * 99 / 100];
+        // Time not spent in the decoder: admission retries, the decoder
+        // pool and the service's own locks.
+        state.counters["wait_us"] = sum / mUs.size() - decodeLatency.count();
+
+        mUs.clear();
+    }
+
+private:
+    std::mutex mLock;
+    std::vector<int64_t> mUs;
+};
+
+struct Fixture {
+    explicit Fixture(const Resolution &resolution)
+        : resolution(resolution),
+          service(new SbwcDecompService(SbwcSimulatedDecoder::factory(stats, resolution.latency), gralloc)),
+          src(gralloc->allocate(resolution.width, resolution.height)) {}
+
+    const Resolution &resolution;
+    std::shared_ptr<SbwcSimulatedDecoderStats> stats = std::make_shared<SbwcSimulatedDecoderStats>();
+    std::shared_ptr<SbwcFakeGralloc> gralloc = std::make_shared<SbwcFakeGralloc>();
+    sp<SbwcDecompService> service;
+    native_handle_t *src;
+    LatencyRecorder latencies;
+};
+
+// One service per resolution, so each has the decoder latency of its frames.
+Fixture &fixture(int resolution)
+{
+    static Fixture *instances[RESOLUTION_COUNT] = {
+        new Fixture(RESOLUTIONS[0]), new Fixture(RESOLUTIONS[1]), new Fixture(RESOLUTIONS[2]),
+    };
+    return *instances[resolution];
+}
+
+}  // namespace
+
+// Every thread decodes to its own buffer, as separate clients do.
+// Throughput should scale until the decoder pool is exhausted.
+static void BM_Decode(benchmark::State &state)
+{
+    Fixture &f = fixture(state.range(0));
+    const uint32_t width = f.resolution.width;
+    const uint32_t height = f.resolution.height;
+    native_handle_t *dst = f.gralloc->allocate(width, height);
+
+    int64_t busy = 0;
+    for (auto _ : state) {
+        auto start = Clock::now();
+        int32_t error;
+        // A rejected decode returns at once, retry it like a client would.
+        while ((error = f.service->decodeWithCrop(f.src, dst, 0, width, height)) == SbwcDecompService::ERROR_BUSY) {
+            busy++;
+            std::this_thread::yield();
+        }
+        if (error != android::NO_ERROR)
+            state.SkipWithError("decode failed");
+        f.latencies.add(Clock::now() - start);
+    }
+
+    state.SetLabel(f.resolution.name);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["busy"] = static_cast<double>(busy);
+    if (state.thread_index() == 0)
+        f.latencies.report(state, f.resolution.latency);
+    f.gralloc->free(dst);
+}
+BENCHMARK(BM_Decode)->DenseRange(0, RESOLUTION_COUNT - 1)->ThreadRange(1, 8)->UseRealTime();
+
+// One client decoding several buffers per call. Rejected jobs are counted
+// apart so that they do not pass for throughput. The simulated decoder
+// writes nothing, so jobs share a few destinations to bound memory at 8K.
+static void BM_DecodeBatch(benchmark::State &state)
+{
+    Fixture &f = fixture(state.range(0));
+    const uint32_t width = f.resolution.width;
+    const uint32_t height = f.resolution.height;
+
+    std::vector<native_handle_t *> dsts;
+    hidl_vec<DecodeJob> jobs;
+    jobs.resize(state.range(1));
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (dsts.size() < 4)
+            dsts.push_back(f.gralloc->allocate(width, height));
+        jobs[i] = { f.src, dsts[i % dsts.size()], 0, width, height, 0 };
+    }
+
+    int64_t decoded = 0;
+    int64_t busy = 0;
+    for (auto _ : state) {
+        auto start = Clock::now();
+        f.service->decodeBatch(jobs, [&decoded, &busy](const hidl_vec<int32_t> &errors) {
+            for (int32_t error : errors) {
+                decoded += error == android::NO_ERROR;
+                busy += error == SbwcDecompService::ERROR_BUSY;
+            }
+        });
+        f.latencies.add(Clock::now() - start);
+    }
+
+    state.SetLabel(f.resolution.name);
+    state.SetItemsProcessed(decoded);
+    state.counters["busy"] = static_cast<double>(busy);
+    // A batch call lasts for all of its jobs, one round per pool's worth.
+    const size_t decoders = SbwcDecoderPool::defaultCapacity();
+    f.latencies.report(state, f.resolution.latency * static_cast<int>((jobs.size() + decoders - 1) / decoders));
+
+    for (auto *dst : dsts)
+        f.gralloc->free(dst);
+}
+static void BatchArgs(benchmark::internal::Benchmark *benchmark)
+{
+    for (int resolution = 0; resolution < RESOLUTION_COUNT; resolution++)
+        for (int jobs = 1; jobs <= 32; jobs *= 2)
+            benchmark->Args({ resolution, jobs });
+}
+BENCHMARK(BM_DecodeBatch)->Apply(BatchArgs)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,514 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SbwcDecompService.h"
+#include "SbwcFakeGralloc.h"
+#include "SbwcImage.h"
+#include "SbwcSimulatedDecoder.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+namespace {
+
+using ::android::hardware::MessageQueue;
+using ::android::hardware::MQDescriptorSync;
+using ::android::hardware::kSynchronizedReadWrite;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::ISbwcDecompSession;
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_1::SessionCompletion;
+
+constexpr uint32_t WIDTH = 64;
+constexpr uint32_t HEIGHT = 32;
+constexpr std::chrono::microseconds LATENCY{2000};
+
+class SbwcDecodeCallback : public ISbwcDecodeCallback {
+public:
+    Return<void> onDecodeDone(int32_t error) override
+    {
+        mResult.set_value(error);
+        return Void();
+    }
+
+    std::future<int32_t> result() { return mResult.get_future(); }
+
+private:
+    std::promise<int32_t> mResult;
+};
+
+class SbwcDecompServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        mStats = std::make_shared<SbwcSimulatedDecoderStats>();
+        mGralloc = std::make_shared<SbwcFakeGralloc>();
+        mService = new SbwcDecompService(SbwcSimulatedDecoder::factory(mStats, LATENCY), mGralloc);
+
+        mSrc = mGralloc->allocate(WIDTH, HEIGHT);
+        mDst = mGralloc->allocate(WIDTH, HEIGHT);
+        ASSERT_NE(mSrc, nullptr);
+        ASSERT_NE(mDst, nullptr);
+    }
+
+    void TearDown() override
+    {
+        mService.clear();
+        EXPECT_EQ(mGralloc->imports(), 0);
+
+        mGralloc->free(mSrc);
+        mGralloc->free(mDst);
+    }
+
+    std::shared_ptr<SbwcSimulatedDecoderStats> mStats;
+    std::shared_ptr<SbwcFakeGralloc> mGralloc;
+    sp<SbwcDecompService> mService;
+    native_handle_t *mSrc = nullptr;
+    native_handle_t *mDst = nullptr;
+};
+
+TEST_F(SbwcDecompServiceTest, DecodeTakesSizeFromBuffer)
+{
+    EXPECT_EQ(static_cast<int32_t>(mService->decode(mSrc, mDst, 0)), android::NO_ERROR);
+
+    EXPECT_EQ(mStats->decodes.load(), 1u);
+    EXPECT_EQ(mStats->lastCropWidth.load(), WIDTH);
+    EXPECT_EQ(mStats->lastCropHeight.load(), HEIGHT);
+}
+
+TEST_F(SbwcDecompServiceTest, DecodeCachesBufferInfo)
+{
+    for (int i = 0; i < 4; i++)
+        ASSERT_EQ(static_cast<int32_t>(mService->decode(mSrc, mDst, 0)), android::NO_ERROR);
+
+    EXPECT_EQ(mGralloc->infoQueries(), 1u);
+}
+
+TEST_F(SbwcDecompServiceTest, UnusedImportsExpire)
+{
+    SbwcBufferCache cache(*mGralloc, 4, std::chrono::milliseconds(10));
+
+    SbwcBufferInfo info;
+    ASSERT_TRUE(cache.lookup(mSrc, info));
+    ASSERT_NE(cache.import(mSrc, info, GRALLOC_USAGE_SW_READ_OFTEN), nullptr);
+    EXPECT_EQ(mGralloc->imports(), 1);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (mGralloc->imports() > 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(mGralloc->imports(), 0);
+
+    // The metadata stays cached.
+    uint64_t queries = mGralloc->infoQueries();
+    ASSERT_TRUE(cache.lookup(mSrc, info));
+    EXPECT_EQ(mGralloc->infoQueries(), queries);
+}
+
+TEST_F(SbwcDecompServiceTest, OutputCacheCopiesOnlyTheCrop)
+{
+    native_handle_t *previous = mGralloc->allocate(WIDTH, HEIGHT);
+
+    // The caches go before the buffer they import.
+    {
+        SbwcBufferCache buffers(*mGralloc, 4, std::chrono::milliseconds(1000));
+        SbwcOutputCache cache(buffers);
+
+        SbwcBufferInfo srcInfo, previousInfo, dstInfo;
+        ASSERT_TRUE(buffers.lookup(mSrc, srcInfo));
+        ASSERT_TRUE(buffers.lookup(previous, previousInfo));
+        ASSERT_TRUE(buffers.lookup(mDst, dstInfo));
+
+        auto fill = [&buffers](native_handle_t *handle, const SbwcBufferInfo &info, uint8_t value) {
+            SbwcLockedImage image(buffers.import(handle, info, GRALLOC_USAGE_SW_WRITE_OFTEN), info,
+                                  GRALLOC_USAGE_SW_WRITE_OFTEN);
+            ASSERT_TRUE(image.valid());
+            for (uint32_t y = 0; y < HEIGHT; y++)
+                memset(image.image().y + y * image.image().yStride, value, WIDTH);
+        };
+        fill(previous, previousInfo, 0x11);
+        fill(mDst, dstInfo, 0xee);
+
+        cache.store(srcInfo, previousInfo, previous, 0, WIDTH / 2, HEIGHT / 2);
+        ASSERT_TRUE(cache.reuse(srcInfo, dstInfo, mDst, 0, WIDTH / 2, HEIGHT / 2));
+
+        SbwcLockedImage result(buffers.import(mDst, dstInfo, GRALLOC_USAGE_SW_READ_OFTEN), dstInfo,
+                               GRALLOC_USAGE_SW_READ_OFTEN);
+        ASSERT_TRUE(result.valid());
+        const SbwcImage &image = result.image();
+        EXPECT_EQ(image.y[0], 0x11);
+        EXPECT_EQ(image.y[WIDTH / 2 - 1], 0x11);
+        EXPECT_EQ(image.y[WIDTH / 2], 0xee);
+        EXPECT_EQ(image.y[(HEIGHT / 2) * image.yStride], 0xee);
+    }
+
+    mGralloc->free(previous);
+}
+
+TEST_F(SbwcDecompServiceTest, ScaleIntoFullSizeDestinationIsInPlace)
+{
+    SbwcBufferCache buffers(*mGralloc, 4, std::chrono::milliseconds(1000));
+    SbwcBufferInfo dstInfo;
+    ASSERT_TRUE(buffers.lookup(mDst, dstInfo));
+
+    // The simulated decoder writes nothing, so this stands in for the decoded frame.
+    {
+        SbwcLockedImage frame(buffers.import(mDst, dstInfo, GRALLOC_USAGE_SW_WRITE_OFTEN), dstInfo,
+                              GRALLOC_USAGE_SW_WRITE_OFTEN);
+        ASSERT_TRUE(frame.valid());
+        for (uint32_t y = 0; y < HEIGHT; y++)
+            memset(frame.image().y + y * frame.image().yStride, y * 4, WIDTH);
+    }
+
+    ASSERT_EQ(static_cast<int32_t>(mService->decodeWithScale(mSrc, mDst, 0, 1, ScaleFilter::BOX, 0)),
+              android::NO_ERROR);
+    EXPECT_EQ(mStats->lastCropWidth.load(), WIDTH);
+    EXPECT_EQ(mStats->lastCropHeight.load(), HEIGHT);
+
+    {
+        SbwcLockedImage result(buffers.import(mDst, dstInfo, GRALLOC_USAGE_SW_READ_OFTEN), dstInfo,
+                               GRALLOC_USAGE_SW_READ_OFTEN);
+        ASSERT_TRUE(result.valid());
+        const SbwcImage &image = result.image();
+        for (uint32_t y = 0; y < HEIGHT / 2; y++) {
+            EXPECT_EQ(image.y[y * image.yStride], y * 8 + 2) << y;
+            EXPECT_EQ(image.y[y * image.yStride + WIDTH / 2 - 1], y * 8 + 2) << y;
+        }
+    }
+}
+
+TEST_F(SbwcDecompServiceTest, DecodeFailureIsReported)
+{
+    EXPECT_EQ(static_cast<int32_t>(mService->decodeWithCrop(mSrc, mDst, 0, 0, 0)), android::BAD_VALUE);
+    EXPECT_EQ(static_cast<int32_t>(mService->decode(nullptr, mDst, 0)), android::BAD_VALUE);
+    EXPECT_EQ(mStats->decodes.load(), 0u);
+}
+
+TEST_F(SbwcDecompServiceTest, ConcurrencyIsBoundedByPool)
+{
+    const size_t capacity = SbwcDecoderPool::defaultCapacity();
+    const size_t clients = capacity * 2;
+
+    std::vector<native_handle_t *> dsts;
+    for (size_t i = 0; i < clients; i++)
+        dsts.push_back(mGralloc->allocate(WIDTH, HEIGHT));
+
+    std::vector<std::thread> threads;
+    std::vector<int32_t> errors(clients);
+    for (size_t i = 0; i < clients; i++) {
+        threads.emplace_back([this, &dsts, &errors, i]() {
+            for (int n = 0; n < 8 && errors[i] == android::NO_ERROR; n++)
+                errors[i] = mService->decodeWithCrop(mSrc, dsts[i], 0, WIDTH, HEIGHT);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int32_t error : errors)
+        EXPECT_TRUE(error == android::NO_ERROR || error == SbwcDecompService::ERROR_BUSY) << error;
+
+    EXPECT_LE(mStats->maxActive.load(), capacity);
+    EXPECT_LE(mStats->created.load(), capacity);
+    EXPECT_GT(mStats->decodes.load(), 0u);
+
+    for (auto *dst : dsts)
+        mGralloc->free(dst);
+}
+
+TEST_F(SbwcDecompServiceTest, IdlePoolIsPrewarmedInBackground)
+{
+    auto stats = std::make_shared<SbwcSimulatedDecoderStats>();
+    SbwcDecoderPool pool(2, std::chrono::milliseconds(100), SbwcSimulatedDecoder::factory(stats, LATENCY));
+
+    {
+        auto deadline = SbwcDecoderPool::Clock::now() + std::chrono::seconds(1);
+        SbwcDecoderPool::Lease first = pool.acquire(deadline);
+        SbwcDecoderPool::Lease second = pool.acquire(deadline);
+        ASSERT_TRUE(first && second);
+    }
+    ASSERT_EQ(stats->created.load(), 2u);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (pool.teardowns() == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_EQ(pool.teardowns(), 1u);
+
+    // Both instances come back without anyone acquiring one.
+    pool.prewarm();
+    while (stats->created.load() < 4 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(stats->created.load(), 4u);
+    EXPECT_EQ(pool.coldStarts(), 1u);
+
+    EXPECT_TRUE(pool.acquire(SbwcDecoderPool::Clock::now() + std::chrono::seconds(1)));
+    EXPECT_EQ(stats->created.load(), 4u);
+}
+
+TEST_F(SbwcDecompServiceTest, BatchReportsEachJob)
+{
+    hidl_vec<DecodeJob> jobs;
+    jobs.resize(2);
+    jobs[0] = { nullptr, mDst, 0, 0, 0, 0 };
+    jobs[1] = { mSrc, mDst, 0, WIDTH / 2, HEIGHT / 2, 30 };
+
+    hidl_vec<int32_t> errors;
+    mService->decodeBatch(jobs, [&errors](const hidl_vec<int32_t> &result) { errors = result; });
+
+    ASSERT_EQ(errors.size(), jobs.size());
+    EXPECT_EQ(errors[0], android::BAD_VALUE);
+    EXPECT_EQ(errors[1], android::NO_ERROR);
+    EXPECT_EQ(mStats->decodes.load(), 1u);
+    EXPECT_EQ(mStats->lastCropWidth.load(), WIDTH / 2);
+}
+
+TEST_F(SbwcDecompServiceTest, LargeBatchIsAdmittedWhole)
+{
+    // Far more jobs than decoders or pending slots.
+    hidl_vec<DecodeJob> jobs;
+    jobs.resize(32);
+    for (auto &job : jobs)
+        job = { mSrc, mDst, 0, WIDTH, HEIGHT, 0 };
+
+    hidl_vec<int32_t> errors;
+    mService->decodeBatch(jobs, [&errors](const hidl_vec<int32_t> &result) { errors = result; });
+
+    ASSERT_EQ(errors.size(), jobs.size());
+    for (int32_t error : errors)
+        EXPECT_EQ(error, android::NO_ERROR);
+    EXPECT_EQ(mStats->decodes.load(), jobs.size());
+    EXPECT_LE(mStats->created.load(), SbwcDecoderPool::defaultCapacity());
+}
+
+TEST_F(SbwcDecompServiceTest, WorkerStartsEarliestDeadlineFirst)
+{
+    std::vector<int> order;
+    {
+        SbwcDecodeWorker worker(1);
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+
+        auto now = SbwcDecodeWorker::Clock::now();
+        worker.post(now, [released]() { released.wait(); });
+        worker.post(now + std::chrono::seconds(1), [&order]() { order.push_back(3); });
+        worker.post(now + std::chrono::milliseconds(8), [&order]() { order.push_back(1); });
+        worker.post(now + std::chrono::milliseconds(8), [&order]() { order.push_back(2); });
+        release.set_value();
+    }
+
+    EXPECT_EQ(order, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST_F(SbwcDecompServiceTest, AsyncDecodeCallsBack)
+{
+    sp<SbwcDecodeCallback> callback = new SbwcDecodeCallback();
+    auto result = callback->result();
+
+    ASSERT_EQ(static_cast<int32_t>(mService->decodeAsync(mSrc, mDst, 0, WIDTH, HEIGHT, 60, hidl_handle(), callback)),
+              android::NO_ERROR);
+
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(result.get(), android::NO_ERROR);
+    EXPECT_EQ(mStats->decodes.load(), 1u);
+}
+
+TEST_F(SbwcDecompServiceTest, AsyncDecodeRequiresCallback)
+{
+    EXPECT_EQ(static_cast<int32_t>(mService->decodeAsync(mSrc, mDst, 0, WIDTH, HEIGHT, 60, hidl_handle(), nullptr)),
+              android::BAD_VALUE);
+}
+
+TEST_F(SbwcDecompServiceTest, SessionRoundTrip)
+{
+    sp<ISbwcDecompSession> session;
+    mService->openSession([&session](int32_t error, const sp<ISbwcDecompSession> &opened) {
+        ASSERT_EQ(error, android::NO_ERROR);
+        session = opened;
+    });
+    ASSERT_NE(session, nullptr);
+
+    hidl_vec<hidl_handle> buffers;
+    buffers.resize(2);
+    buffers[0] = mSrc;
+    buffers[1] = mDst;
+
+    hidl_vec<uint32_t> indices;
+    session->registerBuffers(buffers, [&indices](int32_t error, const hidl_vec<uint32_t> &registered) {
+        ASSERT_EQ(error, android::NO_ERROR);
+        indices = registered;
+    });
+    ASSERT_EQ(indices.size(), 2u);
+
+    std::unique_ptr<MessageQueue<SessionJob, kSynchronizedReadWrite>> submitQueue;
+    std::unique_ptr<MessageQueue<SessionCompletion, kSynchronizedReadWrite>> completionQueue;
+    session->getQueues([&](int32_t error, const MQDescriptorSync<SessionJob> &submit,
+                           const MQDescriptorSync<SessionCompletion> &completion) {
+        ASSERT_EQ(error, android::NO_ERROR);
+        submitQueue.reset(new MessageQueue<SessionJob, kSynchronizedReadWrite>(submit));
+        completionQueue.reset(new MessageQueue<SessionCompletion, kSynchronizedReadWrite>(completion));
+    });
+    ASSERT_TRUE(submitQueue && submitQueue->isValid());
+    ASSERT_TRUE(completionQueue && completionQueue->isValid());
+
+    SessionJob jobs[2] = {
+        { 7, indices[0], indices[1], 0, 0, 0, 0 },
+        { 8, indices[0], static_cast<uint32_t>(indices.size()), 0, 0, 0, 0 },
+    };
+    ASSERT_TRUE(submitQueue->writeBlocking(jobs, 2, 5000000000));
+
+    SessionCompletion completions[2];
+    ASSERT_TRUE(completionQueue->readBlocking(completions, 2, 5000000000));
+    EXPECT_EQ(completions[0].cookie, 7u);
+    EXPECT_EQ(completions[0].error, android::NO_ERROR);
+    EXPECT_EQ(completions[1].cookie, 8u);
+    EXPECT_EQ(completions[1].error, android::BAD_VALUE);
+
+    session->close();
+}
+
+TEST_F(SbwcDecompServiceTest, SessionWaitsForCompletionRoom)
+{
+    sp<ISbwcDecompSession> session;
+    mService->openSession([&session](int32_t error, const sp<ISbwcDecompSession> &opened) {
+        ASSERT_EQ(error, android::NO_ERROR);
+        session = opened;
+    });
+    ASSERT_NE(session, nullptr);
+
+    hidl_vec<hidl_handle> buffers;
+    buffers.resize(2);
+    buffers[0] = mSrc;
+    buffers[1] = mDst;
+
+    hidl_vec<uint32_t> indices;
+    session->registerBuffers(buffers, [&indices](int32_t error, const hidl_vec<uint32_t> &registered) {
+        ASSERT_EQ(error, android::NO_ERROR);
+        indices = registered;
+    });
+    ASSERT_EQ(indices.size(), 2u);
+
+    std::unique_ptr<MessageQueue<SessionJob, kSynchronizedReadWrite>> submitQueue;
+    std::unique_ptr<MessageQueue<SessionCompletion, kSynchronizedReadWrite>> completionQueue;
+    session->getQueues([&](int32_t error, const MQDescriptorSync<SessionJob> &submit,
+                           const MQDescriptorSync<SessionCompletion> &completion) {
+        ASSERT_EQ(error, android::NO_ERROR);
+        submitQueue.reset(new MessageQueue<SessionJob, kSynchronizedReadWrite>(submit));
+        completionQueue.reset(new MessageQueue<SessionCompletion, kSynchronizedReadWrite>(completion));
+    });
+    ASSERT_TRUE(submitQueue && completionQueue);
+
+    // More jobs than the completion queue holds, read only once it has been full for a while.
+    constexpr uint32_t JOBS = 24;
+    for (uint32_t cookie = 0; cookie < JOBS; cookie++) {
+        SessionJob job = { cookie, indices[0], indices[1], 0, 0, 0, 0 };
+        ASSERT_TRUE(submitQueue->writeBlocking(&job, 1, 5000000000));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    for (uint32_t cookie = 0; cookie < JOBS; cookie++) {
+        SessionCompletion completion;
+        ASSERT_TRUE(completionQueue->readBlocking(&completion, 1, 5000000000)) << cookie;
+        EXPECT_EQ(completion.cookie, cookie);
+        EXPECT_EQ(completion.error, android::NO_ERROR);
+    }
+
+    session->close();
+}
+
+TEST_F(SbwcDecompServiceTest, FailedRegistrationRegistersNothing)
+{
+    sp<ISbwcDecompSession> session;
+    mService->openSession([&session](int32_t, const sp<ISbwcDecompSession> &opened) { session = opened; });
+    ASSERT_NE(session, nullptr);
+
+    // A null handle after the first buffer fails the whole call.
+    hidl_vec<hidl_handle> buffers;
+    buffers.resize(3);
+    buffers[0] = mSrc;
+    buffers[1] = nullptr;
+    buffers[2] = mDst;
+
+    int32_t result = android::NO_ERROR;
+    session->registerBuffers(buffers, [&result](int32_t error, const hidl_vec<uint32_t> &) { result = error; });
+    EXPECT_EQ(result, android::BAD_VALUE);
+
+    // So no slot was kept and the first buffer still gets index 0.
+    buffers.resize(1);
+    hidl_vec<uint32_t> indices;
+    session->registerBuffers(buffers, [&indices](int32_t, const hidl_vec<uint32_t> &registered) {
+        indices = registered;
+    });
+    ASSERT_EQ(indices.size(), 1u);
+    EXPECT_EQ(indices[0], 0u);
+
+    EXPECT_EQ(static_cast<int32_t>(session->unregisterBuffers({ 1 })), android::BAD_VALUE);
+
+    session->close();
+}
+
+TEST_F(SbwcDecompServiceTest, ConcurrentCloseIsSafe)
+{
+    sp<ISbwcDecompSession> session;
+    mService->openSession([&session](int32_t, const sp<ISbwcDecompSession> &opened) { session = opened; });
+    ASSERT_NE(session, nullptr);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+        threads.emplace_back([&session]() { session->close(); });
+    for (auto &thread : threads)
+        thread.join();
+}
+
+TEST_F(SbwcDecompServiceTest, SessionCountIsCapped)
+{
+    std::vector<sp<ISbwcDecompSession>> sessions;
+    int32_t result = android::NO_ERROR;
+
+    while (result == android::NO_ERROR && sessions.size() < 1024) {
+        mService->openSession([&result, &sessions](int32_t error, const sp<ISbwcDecompSession> &opened) {
+            result = error;
+            if (error == android::NO_ERROR)
+                sessions.push_back(opened);
+        });
+    }
+    EXPECT_EQ(result, SbwcDecompService::ERROR_BUSY);
+    ASSERT_FALSE(sessions.empty());
+
+    // Closing one makes room for another.
+    sessions.back()->close();
+    mService->openSession([&result](int32_t error, const sp<ISbwcDecompSession> &) { result = error; });
+    EXPECT_EQ(result, android::NO_ERROR);
+
+    for (auto &session : sessions)
+        session->close();
+}
+
+}  // namespace
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
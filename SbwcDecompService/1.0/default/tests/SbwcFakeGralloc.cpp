@@ -0,0 +1,138 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cutils/native_handle.h>
+#include "SbwcFakeGralloc.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+SbwcFakeGralloc::~SbwcFakeGralloc()
+{
+}
+
+native_handle_t *SbwcFakeGralloc::allocate(uint32_t width, uint32_t height)
+{
+    native_handle_t *handle = native_handle_create(1, 1);
+    if (!handle)
+        return nullptr;
+
+    handle->data[0] = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    uint64_t id = mNextId++;
+    handle->data[1] = static_cast<int>(id);
+
+    Buffer &buffer = mBuffers[id];
+    buffer.info = { id, width, height, HAL_PIXEL_FORMAT_YCbCr_420_888, width, height };
+    buffer.memory.resize(static_cast<size_t>(width) * height * 3 / 2);
+
+    return handle;
+}
+
+void SbwcFakeGralloc::free(native_handle_t *handle)
+{
+    if (!handle)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mBuffers.erase(getBufferId(handle));
+    }
+
+    native_handle_close(handle);
+    native_handle_delete(handle);
+}
+
+uint64_t SbwcFakeGralloc::getBufferId(const native_handle_t *handle)
+{
+    return static_cast<uint64_t>(handle->data[handle->numFds]);
+}
+
+bool SbwcFakeGralloc::getInfo(const native_handle_t *handle, SbwcBufferInfo &info)
+{
+    mInfoQueries++;
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    auto it = mBuffers.find(getBufferId(handle));
+    if (it == mBuffers.end())
+        return false;
+
+    info = it->second.info;
+    return true;
+}
+
+buffer_handle_t SbwcFakeGralloc::importBuffer(const native_handle_t *handle, const SbwcBufferInfo &, uint32_t)
+{
+    native_handle_t *imported = native_handle_clone(handle);
+    if (imported)
+        mImports++;
+
+    return imported;
+}
+
+void SbwcFakeGralloc::freeBuffer(buffer_handle_t imported)
+{
+    native_handle_t *handle = const_cast<native_handle_t *>(imported);
+
+    native_handle_close(handle);
+    native_handle_delete(handle);
+    mImports--;
+}
+
+bool SbwcFakeGralloc::lockYCbCr(buffer_handle_t imported, uint32_t, uint32_t width, uint32_t height,
+                                android_ycbcr &ycbcr)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    auto it = mBuffers.find(getBufferId(imported));
+    if (it == mBuffers.end() || width > it->second.info.width || height > it->second.info.height)
+        return false;
+
+    Buffer &buffer = it->second;
+    uint8_t *luma = buffer.memory.data();
+    uint8_t *chroma = luma + static_cast<size_t>(buffer.info.stride) * buffer.info.vstride;
+
+    ycbcr.y = luma;
+    ycbcr.cb = chroma;
+    ycbcr.cr = chroma + 1;
+    ycbcr.ystride = buffer.info.stride;
+    ycbcr.cstride = buffer.info.stride;
+    ycbcr.chroma_step = 2;
+
+    return true;
+}
+
+void SbwcFakeGralloc::unlock(buffer_handle_t)
+{
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
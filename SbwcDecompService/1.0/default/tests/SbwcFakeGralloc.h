@@ -0,0 +1,80 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCFAKEGRALLOC_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCFAKEGRALLOC_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SbwcGralloc.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Gralloc stand-in backed by plain memory. Buffers are 8-bit YCbCr 4:2:0
+ * semi-planar. Their handles carry one placeholder fd, so they can be
+ * cloned like real ones, and the buffer id in their first int.
+ */
+class SbwcFakeGralloc : public SbwcGralloc {
+public:
+    ~SbwcFakeGralloc();
+
+    native_handle_t *allocate(uint32_t width, uint32_t height);
+    void free(native_handle_t *handle);
+
+    // Imports not freed yet.
+    int imports() const { return mImports.load(); }
+    uint64_t infoQueries() const { return mInfoQueries.load(); }
+
+    uint64_t getBufferId(const native_handle_t *handle) override;
+    bool getInfo(const native_handle_t *handle, SbwcBufferInfo &info) override;
+    buffer_handle_t importBuffer(const native_handle_t *handle, const SbwcBufferInfo &info, uint32_t usage) override;
+    void freeBuffer(buffer_handle_t imported) override;
+    bool lockYCbCr(buffer_handle_t imported, uint32_t usage, uint32_t width, uint32_t height,
+                   android_ycbcr &ycbcr) override;
+    void unlock(buffer_handle_t imported) override;
+
+private:
+    struct Buffer {
+        SbwcBufferInfo info;
+        std::vector<uint8_t> memory;
+    };
+
+    std::mutex mLock;
+    std::unordered_map<uint64_t, Buffer> mBuffers;
+    uint64_t mNextId = 1;
+    std::atomic<int> mImports{0};
+    std::atomic<uint64_t> mInfoQueries{0};
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
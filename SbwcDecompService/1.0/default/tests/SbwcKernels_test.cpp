@@ -0,0 +1,94 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SbwcKernels.h"
+
+using ::vendor::samsung_slsi::hardware::SbwcDecompService::V1_0::implementation::boxRow2x2;
+
+namespace {
+
+void boxRow2x2Reference(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, uint32_t width)
+{
+    for (uint32_t col = 0; col < width; col++)
+        dst[col] = static_cast<uint8_t>((row0[col * 2] + row0[col * 2 + 1] + row1[col * 2] + row1[col * 2 + 1] + 2) >> 2);
+}
+
+// Runs both versions on rows starting offset bytes into their allocation
+// so that unaligned loads and stores are covered too.
+void expectMatchesReference(const std::vector<uint8_t> &src0, const std::vector<uint8_t> &src1,
+                            uint32_t width, uint32_t offset)
+{
+    std::vector<uint8_t> expected(width + offset, 0xa5);
+    std::vector<uint8_t> actual(width + offset + 1, 0xa5);
+
+    boxRow2x2Reference(src0.data() + offset, src1.data() + offset, expected.data() + offset, width);
+    boxRow2x2(src0.data() + offset, src1.data() + offset, actual.data() + offset, width);
+
+    for (uint32_t col = 0; col < width + offset; col++)
+        ASSERT_EQ(expected[col], actual[col]) << "width " << width << " offset " << offset << " col " << col;
+    // Nothing is written past the row.
+    EXPECT_EQ(0xa5, actual[width + offset]);
+}
+
+}  // namespace
+
+TEST(SbwcKernelsTest, BoxRow2x2MatchesScalarOnRandomRows)
+{
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    for (uint32_t width = 0; width <= 100; width++) {
+        for (uint32_t offset = 0; offset < 4; offset++) {
+            std::vector<uint8_t> src0((width + offset) * 2), src1((width + offset) * 2);
+            for (size_t i = 0; i < src0.size(); i++) {
+                src0[i] = static_cast<uint8_t>(byte(rng));
+                src1[i] = static_cast<uint8_t>(byte(rng));
+            }
+
+            expectMatchesReference(src0, src1, width, offset);
+        }
+    }
+}
+
+TEST(SbwcKernelsTest, BoxRow2x2MatchesScalarOnEveryRoundingCase)
+{
+    // Every sum of four samples, including the ones that round up to 255.
+    const uint32_t width = 1021;
+    std::vector<uint8_t> src0(width * 2), src1(width * 2);
+
+    for (uint32_t col = 0; col < width; col++) {
+        uint32_t total = col;
+        uint8_t samples[4];
+        for (int i = 0; i < 4; i++) {
+            samples[i] = static_cast<uint8_t>(std::min<uint32_t>(total, 255));
+            total -= samples[i];
+        }
+        src0[col * 2] = samples[0];
+        src0[col * 2 + 1] = samples[1];
+        src1[col * 2] = samples[2];
+        src1[col * 2 + 1] = samples[3];
+    }
+
+    expectMatchesReference(src0, src1, width, 0);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCSIMULATEDDECODER_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_SBWCDECOMPSERVICE_V1_0_SBWCSIMULATEDDECODER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "SbwcDecoder.h"
+#include "SbwcDecoderPool.h"
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace SbwcDecompService {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * What the simulated decoders of one pool have seen, shared by all of them.
+ */
+struct SbwcSimulatedDecoderStats {
+    std::atomic<uint32_t> created{0};
+    std::atomic<uint32_t> active{0};
+    std::atomic<uint32_t> maxActive{0};
+    std::atomic<uint64_t> decodes{0};
+    std::atomic<uint32_t> lastCropWidth{0};
+    std::atomic<uint32_t> lastCropHeight{0};
+};
+
+/*
+ * Decoder that takes a fixed time per frame and writes nothing, so the
+ * service can be driven without the hardware. A 0x0 crop fails like the
+ * hardware does.
+ */
+class SbwcSimulatedDecoder : public SbwcDecoder {
+public:
+    SbwcSimulatedDecoder(std::shared_ptr<SbwcSimulatedDecoderStats> stats, std::chrono::microseconds latency)
+        : mStats(std::move(stats)), mLatency(latency)
+    {
+        mStats->created++;
+    }
+
+    bool decode(const native_handle_t *, const native_handle_t *,
+                uint32_t, uint32_t cropWidth, uint32_t cropHeight, uint32_t) override
+    {
+        uint32_t active = ++mStats->active;
+        uint32_t seen = mStats->maxActive.load();
+        while (active > seen && !mStats->maxActive.compare_exchange_weak(seen, active))
+            ;
+
+        std::this_thread::sleep_for(mLatency);
+
+        mStats->lastCropWidth = cropWidth;
+        mStats->lastCropHeight = cropHeight;
+        mStats->active--;
+
+        if (cropWidth == 0 || cropHeight == 0)
+            return false;
+
+        mStats->decodes++;
+        return true;
+    }
+
+    static SbwcDecoderPool::Factory factory(std::shared_ptr<SbwcSimulatedDecoderStats> stats,
+                                            std::chrono::microseconds latency)
+    {
+        return [stats, latency]() {
+            return std::unique_ptr<SbwcDecoder>(new SbwcSimulatedDecoder(stats, latency));
+        };
+    }
+
+private:
+    std::shared_ptr<SbwcSimulatedDecoderStats> mStats;
+    const std::chrono::microseconds mLatency;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace SbwcDecompService
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif
@@ -9,6 +9,7 @@ outputs="vendor/samsung_slsi/hardware/SbwcDecompService/1.0/default"
 #./out/host/linux-x86/bin/hidl-gen -L c++-headers -o $outputs $options vendor.samsung_slsi.hardware.SbwcDecompService@1.0;
 #./out/host/linux-x86/bin/hidl-gen -Lmakefile $options vendor.samsung_slsi.hardware.SbwcDecompService@1.0;
 ./out/host/linux-x86/bin/hidl-gen -Landroidbp $options -o . vendor.samsung_slsi.hardware.SbwcDecompService@1.0;
+./out/host/linux-x86/bin/hidl-gen -Landroidbp $options -o . vendor.samsung_slsi.hardware.SbwcDecompService@1.1;
 
 #./out/host/linux-x86/bin/hidl-gen -L androidbp-impl -o $outputs $options vendor.samsung_slsi.hardware.SbwcDecompService@1.0;
 
@@ -17,6 +17,9 @@ namespace vendor {
 							if (mReqHandle == 0)
 								return;
 
+							if (mFinalizeHook)
+								mFinalizeHook(mReqHandle);
+
 							if (pfn_free_request != nullptr)
 								pfn_free_request(mReqHandle);
 						}
@@ -41,6 +44,12 @@ namespace vendor {
 							pfn_free_request = pfn;
 							return Void();
 						}
+
+						Return<void> EpicHandle::set_finalize_hook(std::function<void(long)> hook)
+						{
+							mFinalizeHook = std::move(hook);
+							return Void();
+						}
 					}  // namespace implementation
 				}  // namespace V1_0
 			}  // namespace epic
@@ -6,6 +6,8 @@
 #include <hidl/Status.h>
 #include <hidl/HidlSupport.h>
 
+#include <functional>
+
 #include "EpicType.h"
 
 namespace vendor {
@@ -34,9 +36,11 @@ namespace vendor {
 							Return<void> diagonostic() override;
 
 							Return<void> set_pfn_finalize(free_request_t pfn);
+							Return<void> set_finalize_hook(std::function<void(long)> hook);
 
 							long mReqHandle;
 							free_request_t pfn_free_request;
+							std::function<void(long)> mFinalizeHook;
 						};
 					}  // namespace implementation
 				}  // namespace V1_0
@@ -1,6 +1,7 @@
 #include "EpicRequest.h"
 #include "EpicHandle.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <sstream>
@@ -11,6 +12,7 @@
 #include <sys/stat.h>
 #include <sys/sendfile.h>
 #include <android/log.h>
+#include <cutils/properties.h>
 
 namespace vendor {
 namespace samsung_slsi {
@@ -19,7 +21,10 @@ namespace epic {
 namespace V1_0 {
 namespace implementation {
 EpicRequest::EpicRequest() :
-	so_handle(nullptr)
+	so_handle(nullptr),
+	mScenarioTable(::epic::EpicScenarioTable::getInstance()),
+	mRegistry(mScenarioTable),
+	mEnforceConflicts(property_get_bool("ro.vendor.epic.enforce_conflicts", false))
 {
 	if (sizeof(long) == sizeof(int))
 		so_handle = dlopen("/vendor/lib/libepic_helper.so", RTLD_NOW);
@@ -73,6 +78,61 @@ EpicRequest::~EpicRequest()
 	dlclose(so_handle);
 }
 
+template <typename Func>
+uint32_t EpicRequest::call_ordered(handleType req_handle, Func &&func)
+{
+	std::shared_ptr<EpicRequestState> state = mRegistry.find(req_handle);
+	if (state == nullptr)
+		return (uint32_t)func();
+
+	std::lock_guard<std::mutex> lock(state->lock);
+	return (uint32_t)func();
+}
+
+template <typename Func>
+uint32_t EpicRequest::acquire_ordered(handleType req_handle, Func &&func)
+{
+	uint32_t duration_usec = 0;
+	std::shared_ptr<EpicRequestState> state = mRegistry.find(req_handle);
+	if (state == nullptr)
+		return (uint32_t)func(nullptr, duration_usec);
+
+	std::lock_guard<std::mutex> lock(state->lock);
+
+	// Only scenarios listed in a conflict pay for the shared lock, and
+	// only when conflicts are enforced.
+	std::unique_lock<std::mutex> conflict_lock(mRegistry.conflict_lock(), std::defer_lock);
+	if (mEnforceConflicts && mRegistry.has_conflicts(*state)) {
+		conflict_lock.lock();
+		if (mRegistry.conflicts(*state)) {
+			__android_log_print(ANDROID_LOG_INFO, "EpicHAL", "Scenario %d conflicts with a held scenario", state->scenario->id);
+			return 0;
+		}
+	}
+
+	bool ret = func(state->scenario, duration_usec);
+	if (ret && conflict_lock.owns_lock())
+		mRegistry.mark_acquired(*state, duration_usec);
+
+	return (uint32_t)ret;
+}
+
+template <typename Func>
+uint32_t EpicRequest::release_ordered(handleType req_handle, Func &&func)
+{
+	std::shared_ptr<EpicRequestState> state = mRegistry.find(req_handle);
+	if (state == nullptr)
+		return (uint32_t)func();
+
+	std::lock_guard<std::mutex> lock(state->lock);
+
+	bool ret = func();
+	if (ret)
+		mRegistry.mark_released(*state);
+
+	return (uint32_t)ret;
+}
+
 // Methods from ::hardware::samsung_slsi::hardware::epic::V1_0::IEpicRequest follow.
 Return<sp<IEpicHandle>> EpicRequest::init(int32_t scenario_id) {
 	if (pfn_alloc_request == nullptr)
@@ -80,13 +140,7 @@ Return<sp<IEpicHandle>> EpicRequest::init(int32_t scenario_id) {
 
 	handleType req_handle = pfn_alloc_request(scenario_id);
 
-	EpicHandle *ret_instance = new EpicHandle();
-	ret_instance->set_pfn_finalize(pfn_free_request);
-
-	sp<IEpicHandle> ret = ret_instance;
-	ret->init(req_handle);
-
-	return ret;
+	return create_handle(req_handle, mScenarioTable.find(scenario_id));
 }
 
 Return<sp<IEpicHandle>> EpicRequest::init_multi(const hidl_vec<int32_t>& scenario_id_list) {
@@ -95,13 +149,7 @@ Return<sp<IEpicHandle>> EpicRequest::init_multi(const hidl_vec<int32_t>& scenari
 
 	handleType req_handle = pfn_alloc_multi_request(scenario_id_list.data(), scenario_id_list.size());
 
-	EpicHandle *ret_instance = new EpicHandle();
-	ret_instance->set_pfn_finalize(pfn_free_request);
-
-	sp<IEpicHandle> ret = ret_instance;
-	ret->init(req_handle);
-
-	return ret;
+	return create_handle(req_handle, nullptr);
 }
 
 Return<uint32_t> EpicRequest::update_handle_id(const sp<IEpicHandle> &handle, const hidl_string &handle_id) {
@@ -114,8 +162,10 @@ Return<uint32_t> EpicRequest::update_handle_id(const sp<IEpicHandle> &handle, co
 		pfn_update_handle == nullptr)
 		return false;
 
-	pfn_update_handle(req_handle, handle_id.c_str());
-	return true;
+	return call_ordered(req_handle, [&]() {
+		pfn_update_handle(req_handle, handle_id.c_str());
+		return true;
+	});
 }
 
 Return<uint32_t> EpicRequest::acquire_lock(const sp<IEpicHandle> &handle) {
@@ -128,7 +178,18 @@ Return<uint32_t> EpicRequest::acquire_lock(const sp<IEpicHandle> &handle) {
 		pfn_acquire == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_acquire(req_handle);
+	return acquire_ordered(req_handle, [&](const ::epic::EpicScenario *scenario, uint32_t &duration_usec) {
+		// Scenarios with a configured default are acquired with that option
+		// so the boost level can be tuned per SoC from the scenario table.
+		if (scenario != nullptr &&
+			(scenario->default_value != 0 || scenario->duration_usec != 0) &&
+			pfn_acquire_option != nullptr) {
+			duration_usec = scenario->duration_usec;
+			return pfn_acquire_option(req_handle, scenario->default_value, scenario->duration_usec);
+		}
+
+		return pfn_acquire(req_handle);
+	});
 }
 
 Return<uint32_t> EpicRequest::release_lock(const sp<IEpicHandle> &handle) {
@@ -141,7 +202,9 @@ Return<uint32_t> EpicRequest::release_lock(const sp<IEpicHandle> &handle) {
 		pfn_release == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_release(req_handle);
+	return release_ordered(req_handle, [&]() {
+		return pfn_release(req_handle);
+	});
 }
 
 Return<uint32_t> EpicRequest::acquire_lock_option(const sp<IEpicHandle> &handle, uint32_t value, uint32_t usec) {
@@ -154,7 +217,10 @@ Return<uint32_t> EpicRequest::acquire_lock_option(const sp<IEpicHandle> &handle,
 		pfn_acquire_option == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_acquire_option(req_handle, value, usec);
+	return acquire_ordered(req_handle, [&](const ::epic::EpicScenario *, uint32_t &duration_usec) {
+		duration_usec = usec;
+		return pfn_acquire_option(req_handle, value, usec);
+	});
 }
 
 Return<uint32_t> EpicRequest::acquire_lock_multi_option(const sp<IEpicHandle> &handle, const hidl_vec<uint32_t>& value_list, const hidl_vec<uint32_t>& usec_list) {
@@ -167,7 +233,18 @@ Return<uint32_t> EpicRequest::acquire_lock_multi_option(const sp<IEpicHandle> &h
 		pfn_acquire_multi_option == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_acquire_multi_option(req_handle, value_list.data(), usec_list.data(), value_list.size());
+	return acquire_ordered(req_handle, [&](const ::epic::EpicScenario *, uint32_t &duration_usec) {
+		// The hold lasts as long as its longest entry, 0 never expires.
+		for (size_t i = 0; i < usec_list.size(); ++i) {
+			if (usec_list[i] == 0) {
+				duration_usec = 0;
+				break;
+			}
+			duration_usec = std::max(duration_usec, usec_list[i]);
+		}
+
+		return pfn_acquire_multi_option(req_handle, value_list.data(), usec_list.data(), value_list.size());
+	});
 }
 
 Return<uint32_t> EpicRequest::acquire_lock_conditional(const sp<IEpicHandle> &handle, const hidl_string &condition_name) {
@@ -180,7 +257,9 @@ Return<uint32_t> EpicRequest::acquire_lock_conditional(const sp<IEpicHandle> &ha
 		pfn_acquire_conditional == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_acquire_conditional(req_handle, condition_name.c_str(), condition_name.size());
+	return call_ordered(req_handle, [&]() {
+		return pfn_acquire_conditional(req_handle, condition_name.c_str(), condition_name.size());
+	});
 }
 
 Return<uint32_t> EpicRequest::release_lock_conditional(const sp<IEpicHandle> &handle, const hidl_string &condition_name) {
@@ -193,7 +272,9 @@ Return<uint32_t> EpicRequest::release_lock_conditional(const sp<IEpicHandle> &ha
 		pfn_release_conditional == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_release_conditional(req_handle, condition_name.c_str(), condition_name.size());
+	return call_ordered(req_handle, [&]() {
+		return pfn_release_conditional(req_handle, condition_name.c_str(), condition_name.size());
+	});
 }
 
 Return<uint32_t> EpicRequest::perf_hint(const sp<IEpicHandle> &handle, const hidl_string& name) {
@@ -206,7 +287,9 @@ Return<uint32_t> EpicRequest::perf_hint(const sp<IEpicHandle> &handle, const hid
 		pfn_hint == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_hint(req_handle, name.c_str(), name.size());
+	return call_ordered(req_handle, [&]() {
+		return pfn_hint(req_handle, name.c_str(), name.size());
+	});
 }
 
 Return<uint32_t> EpicRequest::hint_release(const sp<IEpicHandle> &handle, const hidl_string& name) {
@@ -219,7 +302,9 @@ Return<uint32_t> EpicRequest::hint_release(const sp<IEpicHandle> &handle, const
 		pfn_hint_release == nullptr)
 		return 0;
 
-	return (uint32_t)pfn_hint_release(req_handle, name.c_str(), name.size());
+	return call_ordered(req_handle, [&]() {
+		return pfn_hint_release(req_handle, name.c_str(), name.size());
+	});
 }
 
 Return<void> EpicRequest::debug(const hidl_handle& fd, const hidl_vec<hidl_string>& __unused options) {
@@ -284,6 +369,22 @@ Return<void> EpicRequest::debug(const hidl_handle& fd, const hidl_vec<hidl_strin
 	return Void();
 }
 
+sp<IEpicHandle> EpicRequest::create_handle(handleType req_handle, const ::epic::EpicScenario *scenario)
+{
+	EpicHandle *ret_instance = new EpicHandle();
+	ret_instance->set_pfn_finalize(pfn_free_request);
+
+	if (req_handle != 0) {
+		mRegistry.insert(req_handle, scenario);
+		ret_instance->set_finalize_hook([this](long handle) { mRegistry.erase(handle); });
+	}
+
+	sp<IEpicHandle> ret = ret_instance;
+	ret->init(req_handle);
+
+	return ret;
+}
+
 // Methods from ::android::hidl::base::V1_0::IBase follow.
 IEpicRequest* HIDL_FETCH_IEpicRequest(const char* /* name */) {
 	return new EpicRequest();
@@ -8,6 +8,8 @@
 #include <hidl/HidlSupport.h>
 
 #include "EpicType.h"
+#include "EpicScenarioTable.h"
+#include "EpicRequestRegistry.h"
 
 namespace vendor {
 	namespace samsung_slsi {
@@ -45,8 +47,26 @@ namespace vendor {
 
 							Return<void> debug(const hidl_handle& fd, const hidl_vec<hidl_string>& options) override;
 
+							sp<IEpicHandle> create_handle(handleType req_handle, const ::epic::EpicScenario *scenario);
+
+							// Helper calls on one handle are serialized through its registry
+							// state, calls on different handles proceed in parallel. The
+							// acquire functor reports how long the hold lasts, 0 until released.
+							template <typename Func>
+							uint32_t call_ordered(handleType req_handle, Func &&func);
+							template <typename Func>
+							uint32_t acquire_ordered(handleType req_handle, Func &&func);
+							template <typename Func>
+							uint32_t release_ordered(handleType req_handle, Func &&func);
+
 							void *so_handle;
 
+							const ::epic::EpicScenarioTable &mScenarioTable;
+							EpicRequestRegistry mRegistry;
+							// ro.vendor.epic.enforce_conflicts: refuse acquires that conflict
+							// with a held scenario of the table. Off by default.
+							const bool mEnforceConflicts;
+
 							init_t pfn_init;
 							term_t pfn_term;
 							alloc_request_t pfn_alloc_request;
@@ -0,0 +1,92 @@
+#include "EpicRequest.h"
+
+#include <atomic>
+#include <chrono>
+
+#include <benchmark/benchmark.h>
+
+using vendor::samsung_slsi::hardware::epic::V1_0::IEpicHandle;
+using vendor::samsung_slsi::hardware::epic::V1_0::implementation::EpicRequest;
+using ::android::sp;
+
+namespace {
+	constexpr int HELPER_LATENCY_USEC = 20;
+
+	std::atomic<long> gNextHandle(1);
+
+	// Stands in for libepic_helper, each call costs about as much as a
+	// sysfs write on device.
+	void helper_work()
+	{
+		auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(HELPER_LATENCY_USEC);
+		while (std::chrono::steady_clock::now() < end)
+			;
+	}
+
+	handleType fake_alloc_request(int)
+	{
+		return gNextHandle.fetch_add(1) << 4;
+	}
+
+	void fake_free_request(handleType)
+	{
+	}
+
+	bool fake_acquire(handleType)
+	{
+		helper_work();
+		return true;
+	}
+
+	bool fake_release(handleType)
+	{
+		helper_work();
+		return true;
+	}
+
+	EpicRequest &request()
+	{
+		static EpicRequest *instance = []() {
+			EpicRequest *req = new EpicRequest();
+			req->pfn_alloc_request = fake_alloc_request;
+			req->pfn_free_request = fake_free_request;
+			req->pfn_acquire = fake_acquire;
+			req->pfn_release = fake_release;
+			return req;
+		}();
+
+		return *instance;
+	}
+}
+
+// Every thread acquires and releases its own handle, as separate clients of
+// the service do. Throughput should scale with the thread count.
+static void BM_AcquireRelease(benchmark::State &state)
+{
+	EpicRequest &req = request();
+	sp<IEpicHandle> handle = req.init(0);
+
+	for (auto _ : state) {
+		req.acquire_lock(handle);
+		req.release_lock(handle);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AcquireRelease)->ThreadRange(1, 8)->UseRealTime();
+
+// All threads share one handle, calls are expected to stay serialized.
+static void BM_AcquireReleaseShared(benchmark::State &state)
+{
+	static sp<IEpicHandle> handle = request().init(0);
+
+	for (auto _ : state) {
+		request().acquire_lock(handle);
+		request().release_lock(handle);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AcquireReleaseShared)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,182 @@
+#include "EpicRequestRegistry.h"
+
+#include <chrono>
+
+namespace vendor {
+namespace samsung_slsi {
+namespace hardware {
+namespace epic {
+namespace V1_0 {
+namespace implementation {
+EpicRequestRegistry::EpicRequestRegistry(const ::epic::EpicScenarioTable &table) :
+	mTable(table),
+	mHeld(new int[table.size()]),
+	mHeldUntil(new std::multiset<int64_t>[table.size()]),
+	mInConflict(new bool[table.size()])
+{
+	for (size_t i = 0; i < mTable.size(); ++i) {
+		mHeld[i] = 0;
+		mInConflict[i] = false;
+	}
+
+	// A conflict declared on one side only still binds both scenarios.
+	for (size_t i = 0; i < mTable.size(); ++i) {
+		for (size_t j = i + 1; j < mTable.size(); ++j) {
+			if (mTable.conflicts(mTable.at(i), mTable.at(j)))
+				mInConflict[i] = mInConflict[j] = true;
+		}
+	}
+}
+
+EpicRequestRegistry::~EpicRequestRegistry()
+{
+}
+
+std::shared_ptr<EpicRequestState> EpicRequestRegistry::insert(handleType req_handle, const ::epic::EpicScenario *scenario)
+{
+	auto state = std::make_shared<EpicRequestState>();
+	state->scenario = scenario;
+	state->acquired = false;
+	state->held_until = 0;
+
+	Shard &shard = shard_of(req_handle);
+	std::unique_lock<std::shared_mutex> lock(shard.lock);
+	shard.map[req_handle] = state;
+
+	return state;
+}
+
+std::shared_ptr<EpicRequestState> EpicRequestRegistry::find(handleType req_handle)
+{
+	Shard &shard = shard_of(req_handle);
+	std::shared_lock<std::shared_mutex> lock(shard.lock);
+
+	auto it = shard.map.find(req_handle);
+	return (it != shard.map.end()) ? it->second : nullptr;
+}
+
+std::shared_ptr<EpicRequestState> EpicRequestRegistry::erase(handleType req_handle)
+{
+	std::shared_ptr<EpicRequestState> state;
+
+	{
+		Shard &shard = shard_of(req_handle);
+		std::unique_lock<std::shared_mutex> lock(shard.lock);
+
+		auto it = shard.map.find(req_handle);
+		if (it == shard.map.end())
+			return nullptr;
+
+		state = std::move(it->second);
+		shard.map.erase(it);
+	}
+
+	std::lock_guard<std::mutex> lock(state->lock);
+	mark_released(*state);
+
+	return state;
+}
+
+bool EpicRequestRegistry::has_conflicts(const EpicRequestState &state) const
+{
+	if (state.scenario == nullptr)
+		return false;
+
+	return mInConflict[mTable.indexOf(state.scenario)];
+}
+
+bool EpicRequestRegistry::conflicts(const EpicRequestState &state)
+{
+	if (!has_conflicts(state))
+		return false;
+
+	int64_t now = now_nsec();
+	for (size_t i = 0; i < mTable.size(); ++i) {
+		if (!mInConflict[i])
+			continue;
+
+		// Timed holds that ran out were dropped by the helper.
+		std::multiset<int64_t> &until = mHeldUntil[i];
+		while (!until.empty() && *until.begin() <= now)
+			until.erase(until.begin());
+
+		bool held = mHeld[i] > 0 || !until.empty();
+		if (held && mTable.conflicts(*state.scenario, mTable.at(i)))
+			return true;
+	}
+
+	return false;
+}
+
+void EpicRequestRegistry::mark_acquired(EpicRequestState &state, uint32_t duration_usec)
+{
+	if (!has_conflicts(state))
+		return;
+
+	size_t index = mTable.indexOf(state.scenario);
+
+	if (duration_usec != 0) {
+		// Acquiring again restarts the hold of this handle.
+		std::multiset<int64_t> &until = mHeldUntil[index];
+		if (state.held_until != 0) {
+			auto it = until.find(state.held_until);
+			if (it != until.end())
+				until.erase(it);
+		}
+
+		state.held_until = now_nsec() + static_cast<int64_t>(duration_usec) * 1000;
+		until.insert(state.held_until);
+		return;
+	}
+
+	if (state.acquired)
+		return;
+
+	mHeld[index]++;
+	state.acquired = true;
+}
+
+void EpicRequestRegistry::mark_released(EpicRequestState &state)
+{
+	if (!has_conflicts(state) || (!state.acquired && state.held_until == 0))
+		return;
+
+	size_t index = mTable.indexOf(state.scenario);
+	std::lock_guard<std::mutex> lock(mConflictLock);
+
+	if (state.acquired) {
+		mHeld[index]--;
+		state.acquired = false;
+	}
+
+	if (state.held_until != 0) {
+		// Already gone if it expired before the release.
+		std::multiset<int64_t> &until = mHeldUntil[index];
+		auto it = until.find(state.held_until);
+		if (it != until.end())
+			until.erase(it);
+		state.held_until = 0;
+	}
+}
+
+int64_t EpicRequestRegistry::now_nsec()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+EpicRequestRegistry::Shard &EpicRequestRegistry::shard_of(handleType req_handle)
+{
+	// Handles are heap addresses, drop the alignment bits before picking a shard.
+	unsigned long key = static_cast<unsigned long>(req_handle);
+	key ^= key >> 17;
+
+	return mShards[(key >> 4) % NUM_SHARDS];
+}
+//
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace epic
+}  // namespace hardware
+}  // namespace samsung_slsi
+}  // namespace vendor
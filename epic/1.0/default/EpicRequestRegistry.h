@@ -0,0 +1,89 @@
+#ifndef VENDOR_SAMSUNG_SLSI_HARDWARE_EPIC_V1_0_EPICREQUESTREGISTRY_H
+#define VENDOR_SAMSUNG_SLSI_HARDWARE_EPIC_V1_0_EPICREQUESTREGISTRY_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "EpicType.h"
+#include "EpicScenarioTable.h"
+
+namespace vendor {
+	namespace samsung_slsi {
+		namespace hardware {
+			namespace epic {
+				namespace V1_0 {
+					namespace implementation {
+
+						/**
+						 * Per handle state. lock is held across every helper call
+						 * made for the handle so that calls on one handle stay
+						 * ordered while other handles run in parallel.
+						 */
+						struct EpicRequestState {
+							std::mutex lock;
+							const ::epic::EpicScenario *scenario;
+							bool acquired;
+							int64_t held_until;	// expiry of a timed hold, 0 for none
+						};
+
+						/**
+						 * Handle registry split into independent shards. Lookups only
+						 * take a shared lock on one shard.
+						 *
+						 * Holds are only tracked for scenarios that take part in a
+						 * conflict, under the conflict lock. Holds until release are
+						 * counted, timed holds keep their expiry since the helper drops
+						 * them by itself; either goes away on release.
+						 */
+						class EpicRequestRegistry {
+						public:
+							explicit EpicRequestRegistry(const ::epic::EpicScenarioTable &table);
+							~EpicRequestRegistry();
+
+							std::shared_ptr<EpicRequestState> insert(handleType req_handle, const ::epic::EpicScenario *scenario);
+							std::shared_ptr<EpicRequestState> find(handleType req_handle);
+							std::shared_ptr<EpicRequestState> erase(handleType req_handle);
+
+							// Serializes acquires of scenarios that take part in a conflict,
+							// taken after the state lock.
+							std::mutex &conflict_lock() { return mConflictLock; }
+							bool has_conflicts(const EpicRequestState &state) const;
+
+							// Caller must hold state.lock and conflict_lock() for these two.
+							bool conflicts(const EpicRequestState &state);
+							// duration_usec is 0 for a hold that lasts until released.
+							void mark_acquired(EpicRequestState &state, uint32_t duration_usec);
+							// Caller must hold state.lock, takes conflict_lock() itself.
+							void mark_released(EpicRequestState &state);
+
+						private:
+							constexpr static const size_t NUM_SHARDS = 16;
+
+							struct alignas(64) Shard {
+								std::shared_mutex lock;
+								std::unordered_map<handleType, std::shared_ptr<EpicRequestState>> map;
+							};
+
+							Shard &shard_of(handleType req_handle);
+							static int64_t now_nsec();
+
+							const ::epic::EpicScenarioTable &mTable;
+							Shard mShards[NUM_SHARDS];
+							// Guarded by mConflictLock.
+							std::unique_ptr<int[]> mHeld;
+							std::unique_ptr<std::multiset<int64_t>[]> mHeldUntil;
+							std::unique_ptr<bool[]> mInConflict;
+							std::mutex mConflictLock;
+						};
+					}  // namespace implementation
+				}  // namespace V1_0
+			}  // namespace epic
+		}  // namespace hardware
+	}  // namespace samsung_slsi
+}  // namespace vendor
+
+#endif  // VENDOR_SAMSUNG_SLSI_HARDWARE_EPIC_V1_0_EPICREQUESTREGISTRY_H
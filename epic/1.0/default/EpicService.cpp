@@ -24,6 +24,7 @@
 #include <binder/ProcessState.h>
 
 #include <hidl/LegacySupport.h>
+#include <cutils/properties.h>
 #include "EpicRequest.h"
 
 using android::hardware::configureRpcThreadpool;
@@ -38,6 +39,12 @@ int main()
 {
 	android::ProcessState::initWithDriver("/dev/vndbinder");
 
-	ALOGI("Epic Service started!");
-	return defaultPassthroughServiceImplementation<IEpicRequest>();
+	// Requests on different handles are independent, so several binder
+	// threads may reach the helper at once.
+	int max_threads = property_get_int32("ro.vendor.epic.max_threads", 4);
+	if (max_threads < 1)
+		max_threads = 1;
+
+	ALOGI("Epic Service started with %d threads!", max_threads);
+	return defaultPassthroughServiceImplementation<IEpicRequest>(static_cast<size_t>(max_threads));
 }
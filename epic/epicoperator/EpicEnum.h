@@ -6,6 +6,12 @@ enum eOperator {
         eVideoDecoding,
 };
 
+// Scenario ids used when the scenario table has no matching entry
+enum eScenarioFallback {
+	eScenarioVideoEncoding = 3,
+	eScenarioVideoDecoding = 30000,
+};
+
 enum eCommand {
 	eNone,
 	eAcquire,
@@ -1,10 +1,11 @@
 #include "EpicVideoDecodingOperator.h"
 
 #include "EpicEnum.h"
+#include "EpicScenarioTable.h"
 
 namespace epic {
 	EpicVideoDecodingOperator::EpicVideoDecodingOperator() :
-		EpicBaseOperator(30000),
+		EpicBaseOperator(EpicScenarioTable::getInstance().resolve("video_decoder", eScenarioVideoDecoding)),
 		mConditionName("video_decoder")
 	{
 	}
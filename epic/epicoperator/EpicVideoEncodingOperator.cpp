@@ -1,10 +1,11 @@
 #include "EpicVideoEncodingOperator.h"
 
 #include "EpicEnum.h"
+#include "EpicScenarioTable.h"
 
 namespace epic {
 	EpicVideoEncodingOperator::EpicVideoEncodingOperator() :
-		EpicBaseOperator(3),
+		EpicBaseOperator(EpicScenarioTable::getInstance().resolve("video_encoder", eScenarioVideoEncoding)),
 		mConditionName("video_encoder")
 	{
 	}
@@ -0,0 +1,231 @@
+#include "EpicScenarioTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <android/log.h>
+
+namespace epic {
+	namespace {
+		struct ParsedScenario {
+			std::string name;
+			int32_t id;
+			uint32_t resources;
+			uint32_t default_value;
+			uint32_t duration_usec;
+			std::vector<std::string> conflicts;
+		};
+
+		uint32_t hashName(const char *name)
+		{
+			// FNV-1a
+			uint32_t hash = 2166136261u;
+			for (; *name != '\0'; ++name) {
+				hash ^= static_cast<unsigned char>(*name);
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+
+		std::vector<std::string> splitList(const std::string &field)
+		{
+			std::vector<std::string> list;
+			if (field == "-")
+				return list;
+
+			std::istringstream stream(field);
+			std::string item;
+			while (std::getline(stream, item, ','))
+				if (!item.empty())
+					list.push_back(item);
+
+			return list;
+		}
+	}
+
+	EpicScenarioTable::EpicScenarioTable()
+	{
+	}
+
+	EpicScenarioTable::~EpicScenarioTable()
+	{
+	}
+
+	const EpicScenarioTable &EpicScenarioTable::getInstance()
+	{
+		static const EpicScenarioTable *instance = []() {
+			EpicScenarioTable *table = new EpicScenarioTable();
+			table->load(PATH_CONFIG);
+			return table;
+		}();
+
+		return *instance;
+	}
+
+	bool EpicScenarioTable::load(const char *path)
+	{
+		std::ifstream file(path);
+		if (!file.is_open()) {
+			__android_log_print(ANDROID_LOG_INFO, "EPICSCENARIO", "Couldn't open %s, using built-in scenario ids", path);
+			return false;
+		}
+
+		std::vector<ParsedScenario> parsed;
+		std::string line;
+		int line_no = 0;
+
+		mResourceNames.clear();
+
+		while (std::getline(file, line)) {
+			++line_no;
+
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+
+			std::istringstream fields(line);
+			ParsedScenario scenario;
+			std::string resources, conflicts;
+
+			if (!(fields >> scenario.name))
+				continue;
+
+			if (!(fields >> scenario.id >> resources >> scenario.default_value >> scenario.duration_usec >> conflicts)) {
+				__android_log_print(ANDROID_LOG_ERROR, "EPICSCENARIO", "%s:%d malformed scenario line", path, line_no);
+				continue;
+			}
+
+			scenario.resources = parseResources(resources);
+			scenario.conflicts = splitList(conflicts);
+			parsed.push_back(std::move(scenario));
+		}
+
+		std::sort(parsed.begin(), parsed.end(),
+			  [](const ParsedScenario &lhs, const ParsedScenario &rhs) { return lhs.id < rhs.id; });
+
+		mEntries.clear();
+		mConflictIds.clear();
+		mNameIndex.clear();
+		mNames.clear();
+
+		mEntries.reserve(parsed.size());
+		mNameIndex.reserve(parsed.size());
+		mNames.reserve(parsed.size());
+
+		for (auto &scenario : parsed) {
+			if (!mEntries.empty() && mEntries.back().id == scenario.id) {
+				__android_log_print(ANDROID_LOG_ERROR, "EPICSCENARIO", "Duplicated scenario id %d (%s) ignored",
+						    scenario.id, scenario.name.c_str());
+				continue;
+			}
+
+			EpicScenario entry;
+			entry.id = scenario.id;
+			entry.name_hash = hashName(scenario.name.c_str());
+			entry.resources = scenario.resources;
+			entry.default_value = scenario.default_value;
+			entry.duration_usec = scenario.duration_usec;
+			entry.conflict_offset = 0;
+			entry.conflict_count = 0;
+
+			mNameIndex.emplace_back(entry.name_hash, static_cast<uint16_t>(mEntries.size()));
+			mNames.push_back(scenario.name);
+			mEntries.push_back(entry);
+		}
+
+		std::sort(mNameIndex.begin(), mNameIndex.end());
+
+		// Conflicts may name scenarios declared later in the file, so they
+		// are resolved to ids only once every entry is known.
+		size_t parsed_index = 0;
+		for (auto &entry : mEntries) {
+			while (parsed[parsed_index].id != entry.id)
+				++parsed_index;
+
+			entry.conflict_offset = static_cast<uint16_t>(mConflictIds.size());
+			for (auto &conflict_name : parsed[parsed_index].conflicts) {
+				const EpicScenario *conflict = find(conflict_name.c_str());
+				if (conflict == nullptr) {
+					__android_log_print(ANDROID_LOG_ERROR, "EPICSCENARIO", "Unknown conflict %s for scenario %d",
+							    conflict_name.c_str(), entry.id);
+					continue;
+				}
+
+				mConflictIds.push_back(conflict->id);
+			}
+			entry.conflict_count = static_cast<uint16_t>(mConflictIds.size() - entry.conflict_offset);
+			++parsed_index;
+		}
+
+		__android_log_print(ANDROID_LOG_INFO, "EPICSCENARIO", "Loaded %zu scenarios from %s", mEntries.size(), path);
+
+		return true;
+	}
+
+	const EpicScenario *EpicScenarioTable::find(int32_t id) const
+	{
+		auto it = std::lower_bound(mEntries.begin(), mEntries.end(), id,
+					   [](const EpicScenario &entry, int32_t key) { return entry.id < key; });
+
+		if (it == mEntries.end() || it->id != id)
+			return nullptr;
+
+		return &(*it);
+	}
+
+	const EpicScenario *EpicScenarioTable::find(const char *name) const
+	{
+		if (name == nullptr)
+			return nullptr;
+
+		uint32_t hash = hashName(name);
+		auto it = std::lower_bound(mNameIndex.begin(), mNameIndex.end(), std::make_pair(hash, static_cast<uint16_t>(0)));
+
+		for (; it != mNameIndex.end() && it->first == hash; ++it) {
+			if (mNames[it->second] == name)
+				return &mEntries[it->second];
+		}
+
+		return nullptr;
+	}
+
+	int32_t EpicScenarioTable::resolve(const char *name, int32_t fallback_id) const
+	{
+		const EpicScenario *scenario = find(name);
+
+		return (scenario != nullptr) ? scenario->id : fallback_id;
+	}
+
+	bool EpicScenarioTable::conflicts(const EpicScenario &lhs, const EpicScenario &rhs) const
+	{
+		const int32_t *begin = mConflictIds.data() + lhs.conflict_offset;
+		if (std::find(begin, begin + lhs.conflict_count, rhs.id) != begin + lhs.conflict_count)
+			return true;
+
+		begin = mConflictIds.data() + rhs.conflict_offset;
+		return std::find(begin, begin + rhs.conflict_count, lhs.id) != begin + rhs.conflict_count;
+	}
+
+	uint32_t EpicScenarioTable::parseResources(const std::string &field)
+	{
+		uint32_t mask = 0;
+
+		for (auto &name : splitList(field)) {
+			auto it = std::find(mResourceNames.begin(), mResourceNames.end(), name);
+			if (it == mResourceNames.end()) {
+				if (mResourceNames.size() == MAX_RESOURCES) {
+					__android_log_print(ANDROID_LOG_ERROR, "EPICSCENARIO", "Too many resources, %s ignored", name.c_str());
+					continue;
+				}
+				it = mResourceNames.insert(mResourceNames.end(), name);
+			}
+
+			mask |= 1u << (it - mResourceNames.begin());
+		}
+
+		return mask;
+	}
+}
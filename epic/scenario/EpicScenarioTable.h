@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace epic {
+	/**
+	 * One compiled scenario. Entries are plain data kept in a single
+	 * vector sorted by id so that a lookup touches as few cache lines
+	 * as possible. Names and conflict lists live in side arrays.
+	 */
+	struct EpicScenario {
+		int32_t id;
+		uint32_t name_hash;
+		uint32_t resources;		// bitmask over EpicScenarioTable resource names
+		uint32_t default_value;
+		uint32_t duration_usec;
+		uint16_t conflict_offset;	// first index in the conflict id array
+		uint16_t conflict_count;
+	};
+
+	class EpicScenarioTable {
+	public:
+		EpicScenarioTable();
+		~EpicScenarioTable();
+
+		// Table loaded from PATH_CONFIG on first use. Never modified afterwards.
+		static const EpicScenarioTable &getInstance();
+
+		bool load(const char *path);
+
+		const EpicScenario *find(int32_t id) const;
+		const EpicScenario *find(const char *name) const;
+		int32_t resolve(const char *name, int32_t fallback_id) const;
+		bool conflicts(const EpicScenario &lhs, const EpicScenario &rhs) const;
+
+		size_t size() const { return mEntries.size(); }
+		const EpicScenario &at(size_t index) const { return mEntries[index]; }
+		size_t indexOf(const EpicScenario *scenario) const { return scenario - mEntries.data(); }
+
+		constexpr static const char *PATH_CONFIG = "/vendor/etc/epic/epic_scenarios.conf";
+		constexpr static const size_t MAX_RESOURCES = 32;
+
+	private:
+		uint32_t parseResources(const std::string &field);
+
+		std::vector<EpicScenario> mEntries;
+		std::vector<int32_t> mConflictIds;
+		std::vector<std::pair<uint32_t, uint16_t>> mNameIndex;	// (name hash, entry index) sorted by hash
+		std::vector<std::string> mNames;
+		std::vector<std::string> mResourceNames;
+	};
+}
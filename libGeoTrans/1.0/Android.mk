@@ -13,3 +13,54 @@ LOCAL_SRC_FILES_32 := lib/libGeoTrans10.so
 LOCAL_MULTILIB := both
 LOCAL_SHARED_LIBRARIES := android.hidl.memory@1.0 libc++ libc libcutils libdl libhidlbase libhidlmemory libhidltransport libion liblog libm libutils vendor.samsung_slsi.hardware.geoTransService@1.0
 include $(BUILD_PREBUILT)
+
+include $(CLEAR_VARS)
+LOCAL_MODULE := libGeoTrans10Ext
+LOCAL_SRC_FILES := \
+	src/GeoTransEngine.cpp \
+	src/GeoTransHw.cpp \
+	src/GeoTransWorkers.cpp \
+	src/geo_trans_async.cpp \
+	src/geo_trans_batch.cpp \
+	src/geo_trans_bicubic.cpp \
+	src/geo_trans_buffer_pool.cpp \
+	src/geo_trans_fd.cpp \
+	src/geo_trans_fused.cpp \
+	src/geo_trans_gdc.cpp \
+	src/geo_trans_grid.cpp \
+	src/geo_trans_ion_allocator.cpp \
+	src/geo_trans_session.cpp
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/include
+LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/include
+LOCAL_MULTILIB := both
+LOCAL_SHARED_LIBRARIES := libGeoTrans10 libcutils libion liblog
+include $(BUILD_SHARED_LIBRARY)
+
+# SW paths that do not need the HW service, built for the host as well.
+include $(CLEAR_VARS)
+LOCAL_MODULE := libGeoTrans10Sw
+LOCAL_SRC_FILES := \
+	src/GeoTransWorkers.cpp \
+	src/geo_trans_bicubic.cpp \
+	src/geo_trans_buffer_pool.cpp \
+	src/geo_trans_gdc.cpp
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/include
+LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/include
+LOCAL_SHARED_LIBRARIES := liblog
+include $(BUILD_HOST_STATIC_LIBRARY)
+
+# SW paths against double precision references.
+include $(CLEAR_VARS)
+LOCAL_MODULE := libGeoTrans10Sw_test
+LOCAL_SRC_FILES := tests/geo_trans_sw_test.cpp
+LOCAL_STATIC_LIBRARIES := libGeoTrans10Sw
+LOCAL_SHARED_LIBRARIES := liblog
+include $(BUILD_HOST_NATIVE_TEST)
+
+# SW path throughput, run by hand on the host.
+include $(CLEAR_VARS)
+LOCAL_MODULE := libGeoTrans10Sw_benchmark
+LOCAL_SRC_FILES := tests/geo_trans_sw_benchmark.cpp
+LOCAL_STATIC_LIBRARIES := libGeoTrans10Sw libgoogle-benchmark
+LOCAL_SHARED_LIBRARIES := liblog
+include $(BUILD_HOST_EXECUTABLE)
@@ -16,4 +16,5 @@
 
 # OFI
 PRODUCT_PACKAGES += \
-	libGeoTrans10
+	libGeoTrans10 \
+	libGeoTrans10Ext
@@ -0,0 +1,112 @@
+#ifndef GEO_TRANS_ASYNC_H
+#define GEO_TRANS_ASYNC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <functional>
+#include <future>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_async.h
+ * @brief Asynchronous geoTrans API.
+ *
+ * Every engine (CSC scaler, GDC warper, bicubic SW scaler) owns a queue
+ * and a worker thread, so a client can queue frame N+1 on one engine
+ * while frame N is still in another, and keep working in the meantime.
+ * Jobs of one engine complete in submission order.
+ * initShared() must have been called, or a GeoTransSession must be alive,
+ * before jobs are queued: each job borrows a reference on that client until
+ * it completes, and fails with -ENODEV when there is none. A client brought
+ * up with plain init() is not counted and does not qualify. Buffers must
+ * stay valid until the job completes. The grid and the matrix are copied at submission.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief Called on the engine thread with the status of the job,
+ * before its future becomes ready.
+ */
+typedef std::function<void(int status)> Callback;
+
+/**
+ * @brief engines that run jobs in parallel.
+ */
+enum {
+    ENGINE_CSC = 0x0,
+    ENGINE_GDC = 0x1,
+    ENGINE_BICUBIC = 0x2,
+    ENGINE_COUNT
+};
+
+  /**
+   * @brief
+   * Queue a runCSC() job.
+   * Blocks while the CSC queue already holds the maximum number of jobs
+   * (ro.vendor.geotrans.queue_depth, 4 by default).
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[format] pixel format (0x0 or 0x1)
+   * @param[callback] optional completion callback
+   * @return[output] future of the runCSC() status
+   */
+std::future<int> runCSCAsync(const BufferData& dst, const BufferData& src, int format = PIXEL_FORMAT_YUV_420_SP,
+                             Callback callback = nullptr);
+
+  /**
+   * @brief
+   * Queue a runGDCGrid() job. TARGET_GDC_C_MODEL runs runGDCGridTiled().
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[grid] 33x33 grid data for (x,y) axis
+   * @param[format] pixel format (0x0 or 0x1)
+   * @param[target] target model (0x0 or 0x1)
+   * @param[callback] optional completion callback
+   * @return[output] future of the runGDCGrid() status
+   */
+std::future<int> runGDCGridAsync(const BufferData& dst, const BufferData& src, const GDCGrid& grid,
+                                 int format = PIXEL_FORMAT_YUV_420_SP, int target = TARGET_GDC_HW,
+                                 Callback callback = nullptr);
+
+  /**
+   * @brief
+   * Queue a runGDCMatrixCached() job. TARGET_GDC_C_MODEL runs runGDCGridTiled().
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[affine] 3x2 affine matrix
+   * @param[format] pixel format (0x0 or 0x1)
+   * @param[target] target model (0x0 or 0x1)
+   * @param[callback] optional completion callback
+   * @return[output] future of the runGDCMatrix() status
+   */
+std::future<int> runGDCMatrixAsync(const BufferData& dst, const BufferData& src, const short* affine,
+                                   int format = PIXEL_FORMAT_YUV_420_SP, int target = TARGET_GDC_HW,
+                                   Callback callback = nullptr);
+
+  /**
+   * @brief
+   * Queue a runInterpBicubic() job.
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[format] pixel format (0x0 or 0x1)
+   * @param[callback] optional completion callback
+   * @return[output] future of the runInterpBicubic() status
+   */
+std::future<int> runInterpBicubicAsync(const BufferData& dst, const BufferData& src,
+                                       int format = PIXEL_FORMAT_YUV_420_SP, Callback callback = nullptr);
+
+  /**
+   * @brief
+   * Wait until every job queued so far on every engine has completed.
+   * Each queued job holds a reference on the client until it completes, so
+   * deinitShared() after waitIdle() is the one that calls deinit().
+   */
+void waitIdle();
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
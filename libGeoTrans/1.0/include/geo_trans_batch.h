@@ -0,0 +1,71 @@
+#ifndef GEO_TRANS_BATCH_H
+#define GEO_TRANS_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_batch.h
+ * @brief Batch geoTrans API.
+ *
+ * A batch is queued on the engines of geo_trans_async.h in one go and
+ * waited for once, so jobs on different engines run concurrently and the
+ * caller blocks a single time per batch instead of once per job.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief job type of a batch entry.
+ */
+enum {
+    JOB_CSC = 0x0,
+    JOB_GDC_GRID = 0x1,
+    JOB_GDC_MATRIX = 0x2,
+    JOB_INTERP_BICUBIC = 0x3
+};
+
+/**
+ * @brief one entry of runBatch().
+ * grid is used by JOB_GDC_GRID and affine by JOB_GDC_MATRIX only.
+ */
+struct GeoTransJob {
+    GeoTransJob() : type(JOB_CSC), format(PIXEL_FORMAT_YUV_420_SP), target(TARGET_GDC_HW), grid(NULL), affine(NULL) {}
+    int type;
+    BufferData dst;
+    BufferData src;
+    int format;
+    int target;
+    const GDCGrid* grid;
+    const short* affine;
+};
+
+  /**
+   * @brief
+   * Run CSC from one source to several destinations, e.g. preview, record
+   * and analysis outputs of the same frame. A source with CPU pointers
+   * only is copied into ION once and shared by all destinations.
+   * @param[dsts] destination buffer data
+   * @param[src] source buffer data
+   * @param[format] pixel format (0x0 or 0x1)
+   * @return[output] status of each destination, in order
+   */
+std::vector<int> runCSCBatch(std::vector<BufferData>& dsts, BufferData& src, int format = PIXEL_FORMAT_YUV_420_SP);
+
+  /**
+   * @brief
+   * Run a set of jobs, each on its engine, and wait for all of them.
+   * Jobs that share an engine run in order.
+   * @param[jobs] jobs to run
+   * @return[output] status of each job, in order
+   */
+std::vector<int> runBatch(std::vector<GeoTransJob>& jobs);
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
@@ -0,0 +1,39 @@
+#ifndef GEO_TRANS_BICUBIC_H
+#define GEO_TRANS_BICUBIC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_bicubic.h
+ * @brief Fast bicubic SW scaler.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+  /**
+   * @brief
+   * Run bicubic SW scaler with precomputed filter tables, SIMD vertical
+   * filtering and row stripes spread over several threads.
+   * Drop-in for runInterpBicubic() when the HW scaler is unavailable.
+   * Only y and uv pointers are used, fds are ignored.
+   * ----------------------------------------------------
+   * Image resolution ragne : Input [16x16] ~ [8192x8192]
+   *                          Output [4x4] ~ [8192x8192]
+   * Input/output format    : 8b Y or 8b YCbCr 420 semi-planar
+   * Filter                 : Catmull-Rom, 1/64 pixel phases
+   * Alignment              : multiple of 2 for YCbCr 420
+   * ----------------------------------------------------
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[format] pixel format (0x0 or 0x1)
+   * @return[output] status
+   */
+int runInterpBicubicFast(BufferData& dst, BufferData& src, int format = PIXEL_FORMAT_YUV_420_SP);
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
@@ -0,0 +1,137 @@
+#ifndef GEO_TRANS_BUFFER_POOL_H
+#define GEO_TRANS_BUFFER_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_buffer_pool.h
+ * @brief Reusable geoTrans buffers.
+ *
+ * BufferData with fdY/fdUV set is used by the HW as is, while a buffer
+ * with only CPU pointers is copied into a new ION buffer on every call.
+ * The pool hands out buffers that already have both, and keeps released
+ * buffers for the next request of a similar size.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief buffer usage, selects the alignment of width and height.
+ */
+enum {
+    BUFFER_USAGE_CSC = 0x0,     // multiple of 2
+    BUFFER_USAGE_GDC = 0x1      // multiple of 16
+};
+
+/**
+ * @brief backing memory of a pool.
+ */
+class BufferAllocator {
+public:
+    virtual ~BufferAllocator() {}
+
+    /**
+     * @brief Allocate size bytes, mapped at addr. fd is -1 without dma-buf.
+     * @return[output] status
+     */
+    virtual int allocate(size_t size, int* fd, unsigned char** addr) = 0;
+
+    /**
+     * @brief Free a block returned by allocate().
+     */
+    virtual void free(size_t size, int fd, unsigned char* addr) = 0;
+};
+
+  /**
+   * @brief
+   * Cached ION system heap buffers, as the HW path allocates them.
+   * @return[output] allocator, or NULL if ION cannot be opened
+   */
+std::shared_ptr<BufferAllocator> createIonAllocator();
+
+  /**
+   * @brief
+   * Stand-in allocator on the process heap, every fd is -1.
+   * For host builds and tests.
+   * @return[output] allocator
+   */
+std::shared_ptr<BufferAllocator> createHeapAllocator();
+
+/**
+ * @brief Size class buffer pool, thread-safe.
+ *
+ * Planes are rounded up to size classes, four per power of two, so a
+ * released plane serves any later request of the same class. Released
+ * planes above maxCachedBytes are freed oldest first. Every acquired
+ * buffer must be released before the pool is destroyed, the pool does
+ * not free buffers still out.
+ */
+class BufferPool {
+public:
+    BufferPool(std::shared_ptr<BufferAllocator> allocator, size_t maxCachedBytes = 64 << 20);
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief
+     * Get a buffer of at least width x height. buffer.width and height
+     * are rounded up to the alignment of usage, and the planes are
+     * contiguous with a stride equal to the width. fov covers the
+     * requested size.
+     * @param[buffer] filled on success
+     * @param[width] width in pixels
+     * @param[height] height in pixels
+     * @param[usage] BUFFER_USAGE_CSC or BUFFER_USAGE_GDC
+     * @param[format] pixel format (0x0 or 0x1)
+     * @return[output] status
+     */
+    int acquire(BufferData& buffer, int width, int height, int usage, int format = PIXEL_FORMAT_YUV_420_SP);
+
+    /**
+     * @brief
+     * Give a buffer from acquire() back to the pool and reset buffer.
+     */
+    void release(BufferData& buffer);
+
+    /**
+     * @brief Free every released buffer.
+     */
+    void trim();
+
+    size_t cachedBytes() const;
+
+private:
+    struct Block {
+        size_t size;
+        int fd;
+        unsigned char* addr;
+    };
+
+    int take(size_t size, Block* block);
+    void give(const Block& block);
+
+    static size_t sizeClass(size_t size);
+
+    const std::shared_ptr<BufferAllocator> mAllocator;
+    const size_t mMaxCachedBytes;
+
+    mutable std::mutex mLock;
+    std::list<Block> mFree;                                 // oldest release first
+    std::unordered_map<unsigned char*, Block> mInUse;       // by address
+    size_t mCachedBytes;
+};
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
@@ -0,0 +1,88 @@
+#ifndef GEO_TRANS_FD_H
+#define GEO_TRANS_FD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_fd.h
+ * @brief geoTrans API on dma-buf fds only.
+ *
+ * Jobs are described by fds, offsets and strides, without CPU pointers,
+ * and are handed to the HW without mapping the buffers or syncing CPU
+ * caches. A buffer is mapped only when the SW path has to run instead.
+ * On kernels where every dma-buf has an inode of its own, the size of
+ * every dma-buf and, once made, its mapping are cached per dma-buf across
+ * calls. Elsewhere both are taken again on every call.
+ *
+ * Planes may start at any offset, so the chroma plane may follow the
+ * luma plane in the same fd. Strides must equal the width.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief one plane of a dma-buf backed image.
+ */
+struct FdPlane {
+    FdPlane() : fd(-1), offset(0), stride(0) {}
+    int fd;
+    uint32_t offset;    // bytes from the start of the dma-buf
+    uint32_t stride;    // bytes per row, 0 for the width
+};
+
+/**
+ * @brief dma-buf backed counterpart of BufferData.
+ */
+struct FdBufferData {
+    FdBufferData() : width(0), height(0) {
+        fov.l = 0;
+        fov.t = 0;
+        fov.r = 0;
+        fov.b = 0;
+    }
+    FdPlane y;
+    FdPlane uv;
+    int32_t width;
+    int32_t height;
+    Rect fov;
+};
+
+  /**
+   * @brief
+   * Run CSC Scaler on fds. Same specification as runCSC().
+   * The HW takes planes at offset 0 of their fds, other offsets go to the
+   * SW scaler directly. Strides other than the width return -EINVAL.
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[format] pixel format (0x0 or 0x1)
+   * @return[output] status
+   */
+int runCSCFd(FdBufferData& dst, FdBufferData& src, int format = PIXEL_FORMAT_YUV_420_SP);
+
+  /**
+   * @brief
+   * Run GDC Warper with a GDC grid on fds. Same specification as runGDCGrid().
+   * The HW takes planes at offset 0 of their fds, other offsets go to the
+   * SW warper directly. Strides other than the width return -EINVAL.
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[grid] 33x33 grid data for (x,y) axis
+   * @param[format] pixel format (0x0 or 0x1)
+   * @return[output] status
+   */
+int runGDCGridFd(FdBufferData& dst, FdBufferData& src, GDCGrid& grid, int format = PIXEL_FORMAT_YUV_420_SP);
+
+  /**
+   * @brief
+   * Drop the cached sizes and mappings, e.g. when a buffer queue is torn
+   * down. They otherwise live until evicted by newer buffers.
+   */
+void clearFdImports();
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
@@ -0,0 +1,43 @@
+#ifndef GEO_TRANS_FUSED_H
+#define GEO_TRANS_FUSED_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_fused.h
+ * @brief Warp and scale as one geoTrans operation.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+  /**
+   * @brief
+   * Run GDC Warper and scale the result to the destination size, in
+   * place of runGDCGrid() into an intermediate followed by runCSC().
+   * TARGET_GDC_C_MODEL folds the scale into the grid and warps in one SW
+   * pass when gdcScaleFoldable() allows it.
+   * TARGET_GDC_HW is x1 only, so GDC and CSC are chained through a pooled
+   * dma-buf that is passed by fd only and never touched by the CPU. If
+   * the HW fails, the SW pass runs instead when the scale allows it.
+   * ----------------------------------------------------
+   * Image resolution ragne : Input as runGDCGrid()
+   *                          Output as runCSC()
+   * Scale                  : x1/4 to x8
+   * ----------------------------------------------------
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[grid] 33x33 grid data for (x,y) axis, on the source size
+   * @param[format] pixel format (0x0 or 0x1)
+   * @param[target] target model (0x0 or 0x1)
+   * @return[output] status
+   */
+int runGDCGridScaled(BufferData& dst, BufferData& src, GDCGrid& grid,
+                     int format = PIXEL_FORMAT_YUV_420_SP, int target = TARGET_GDC_HW);
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
@@ -0,0 +1,68 @@
+#ifndef GEO_TRANS_GDC_H
+#define GEO_TRANS_GDC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_gdc.h
+ * @brief Tiled SW GDC Warper.
+ *
+ * Grid nodes sit every round(width / 32) x round(height / 32) pixels and
+ * hold the displacement of the source position, in the encoding getGridSet()
+ * produces for runGDCMatrix(): g = round((2 * d + 1) * 8192 / width) << 8
+ * horizontally, 6144 / height vertically.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+  /**
+   * @brief
+   * Run GDC Warper in SW, in place of runGDCGrid() with TARGET_GDC_C_MODEL.
+   * The output is split into tiles warped in parallel, each tile reading
+   * a compact source window. Displacements are bilinearly interpolated
+   * between grid nodes, samples bilinearly in 1/64 pixel.
+   * Only y and uv pointers are used, fds are ignored.
+   * Same specification as runGDCGrid().
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[grid] 33x33 grid data for (x,y) axis
+   * @param[format] pixel format (0x0 or 0x1)
+   * @return[output] status
+   */
+int runGDCGridTiled(BufferData& dst, BufferData& src, const GDCGrid& grid, int format = PIXEL_FORMAT_YUV_420_SP);
+
+  /**
+   * @brief
+   * Run GDC Warper in SW and scale to the destination size in the same
+   * pass, without an intermediate image. The grid is defined on the
+   * source size, as for runGDCGrid().
+   * ----------------------------------------------------
+   * Image resolution ragne : Input as runGDCGrid()
+   *                          Output [4x4] ~ [8192x8192]
+   * Scale                  : x1/2 to x2, see gdcScaleFoldable()
+   * Alignment              : output multiple of 2 for YCbCr 420
+   * ----------------------------------------------------
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[grid] 33x33 grid data for (x,y) axis
+   * @param[format] pixel format (0x0 or 0x1)
+   * @return[output] status
+   */
+int runGDCGridTiledScaled(BufferData& dst, BufferData& src, const GDCGrid& grid, int format = PIXEL_FORMAT_YUV_420_SP);
+
+  /**
+   * @brief
+   * Whether runGDCGridTiledScaled() takes this pair of sizes.
+   * @param[dst] destination buffer data, only width and height are used
+   * @param[src] source buffer data, only width and height are used
+   * @return[output] true if the scale can be folded into the warp
+   */
+bool gdcScaleFoldable(const BufferData& dst, const BufferData& src);
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
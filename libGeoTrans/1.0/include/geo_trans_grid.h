@@ -0,0 +1,119 @@
+#ifndef GEO_TRANS_GRID_H
+#define GEO_TRANS_GRID_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_grid.h
+ * @brief Reusable GDC grids built from affine matrices.
+ *
+ * The affine matrix of runGDCMatrix() is row-major 3x2, short[6] =
+ * { a00, a01, tx, a10, a11, ty }, where the linear terms are Q12 and the
+ * translations Q5. It is turned into a 33x33 grid with the same routine
+ * runGDCMatrix() uses, so a cached or compiled grid gives the same output.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief compiled grid, immutable and shareable across frames and threads.
+ */
+typedef std::shared_ptr<const GDCGrid> GDCGridHandle;
+
+  /**
+   * @brief
+   * Build the grid of an affine matrix for a source size once.
+   * @param[src] source buffer data, only width and height are used
+   * @param[affine] 3x2 affine matrix
+   * @return[output] grid handle, or NULL on an invalid size
+   */
+GDCGridHandle compileGDCMatrix(const BufferData& src, const short* affine);
+
+/**
+ * @brief LRU cache of compiled grids by source size and matrix, thread-safe.
+ */
+class GDCGridCache {
+public:
+    /**
+     * @param[capacity] grids kept, 0 compiles every time
+     * @param[quantBits] low bits rounded off every matrix term first, so
+     *                   that nearly identical matrices share a grid
+     */
+    GDCGridCache(size_t capacity, int quantBits);
+
+    /**
+     * @brief Grid of an affine matrix, compiled on a miss.
+     * @return[output] grid handle, or NULL on an invalid size
+     */
+    GDCGridHandle get(const BufferData& src, const short* affine);
+
+    // ro.vendor.geotrans.grid_cache_size, 8 by default.
+    static size_t defaultCapacity();
+    // ro.vendor.geotrans.grid_quant_bits, 0 by default.
+    static int defaultQuantBits();
+
+private:
+    static constexpr size_t MATRIX_TERMS = 6;
+
+    struct Key {
+        int32_t width;
+        int32_t height;
+        std::array<short, MATRIX_TERMS> matrix;
+
+        bool operator==(const Key& other) const {
+            return width == other.width && height == other.height && matrix == other.matrix;
+        }
+    };
+
+    short quantize(short value) const;
+
+    const size_t mCapacity;
+    const int mQuantBits;
+
+    std::mutex mLock;
+    std::list<std::pair<Key, GDCGridHandle>> mEntries;     // most recent first
+};
+
+  /**
+   * @brief
+   * Run GDC Warper with a compiled grid. Same specification as runGDCGrid(),
+   * except that TARGET_GDC_C_MODEL runs runGDCGridTiled().
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[grid] grid from compileGDCMatrix()
+   * @param[format] pixel format (0x0 or 0x1)
+   * @param[target] target model (0x0 or 0x1)
+   * @return[output] status
+   */
+int runGDCGridHandle(BufferData& dst, BufferData& src, const GDCGridHandle& grid,
+                     int format = PIXEL_FORMAT_YUV_420_SP, int target = TARGET_GDC_HW);
+
+  /**
+   * @brief
+   * Drop-in replacement of runGDCMatrix() that reuses the grids of recent
+   * matrices (ro.vendor.geotrans.grid_cache_size, 8 by default).
+   * With ro.vendor.geotrans.grid_quant_bits set, that many low bits of
+   * every matrix term are rounded off first so that nearly identical
+   * matrices share a grid. Runs through runGDCGridHandle().
+   * @param[dst] destination buffer data
+   * @param[src] source buffer data
+   * @param[affine] 3x2 affine matrix
+   * @param[format] pixel format (0x0 or 0x1)
+   * @param[target] target model (0x0 or 0x1)
+   * @return[output] status
+   */
+int runGDCMatrixCached(BufferData& dst, BufferData& src, const short* affine,
+                       int format = PIXEL_FORMAT_YUV_420_SP, int target = TARGET_GDC_HW);
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
@@ -0,0 +1,123 @@
+#ifndef GEO_TRANS_SESSION_H
+#define GEO_TRANS_SESSION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <future>
+#include <memory>
+
+#include "geo_trans_async.h"
+#include "geo_trans_buffer_pool.h"
+#include "geo_trans_grid.h"
+#include "geo_trans_interface.h"
+
+/**
+ * @file geo_trans_session.h
+ * @brief Independent geoTrans contexts within one process.
+ *
+ * Each session owns its job queues and worker threads, its ION client and
+ * buffer pool, and its grid cache, so camera sessions neither wait on
+ * each other's queues nor share caches. Sessions and initShared() callers
+ * all count on the one client: the first of them calls init() and the last
+ * one to go calls deinit(), so none of them can take the client away from
+ * the others. Jobs queued on the async API borrow a reference while one is
+ * held and are refused otherwise. Code that mixes
+ * the plain API with sessions or async jobs calls initShared() and
+ * deinitShared() instead of init() and deinit().
+ *
+ * SW jobs run fully in parallel across sessions. HW jobs meet in the
+ * prebuilt client, which keeps the state of each block in globals, so
+ * the CSC and GDC calls of all sessions are serialized per block there.
+ */
+
+namespace hardware {
+namespace geoTransClient {
+
+class GeoTransEngine;
+
+  /**
+   * @brief
+   * init() counted with sessions and queued async jobs.
+   * Only the first reference calls init().
+   * @return[output] status
+   */
+int initShared();
+
+  /**
+   * @brief
+   * deinit() counted with sessions and queued async jobs.
+   * Only the last reference calls deinit().
+   * @return[output] status
+   */
+int deinitShared();
+
+/**
+ * @brief one geoTrans context.
+ */
+class GeoTransSession {
+public:
+    /**
+     * @brief Open a session.
+     * @return[output] session, or NULL if the client cannot be initialized
+     */
+    static std::shared_ptr<GeoTransSession> create();
+
+    /**
+     * @brief Wait for the queued jobs, then drop the client reference.
+     */
+    ~GeoTransSession();
+
+    GeoTransSession(const GeoTransSession&) = delete;
+    GeoTransSession& operator=(const GeoTransSession&) = delete;
+
+    /**
+     * @brief Queue a runCSC() job on this session.
+     */
+    std::future<int> runCSC(const BufferData& dst, const BufferData& src, int format = PIXEL_FORMAT_YUV_420_SP,
+                            Callback callback = nullptr);
+
+    /**
+     * @brief Queue a runGDCGrid() job on this session.
+     * TARGET_GDC_C_MODEL runs the tiled SW warper.
+     */
+    std::future<int> runGDCGrid(const BufferData& dst, const BufferData& src, const GDCGrid& grid,
+                                int format = PIXEL_FORMAT_YUV_420_SP, int target = TARGET_GDC_HW,
+                                Callback callback = nullptr);
+
+    /**
+     * @brief Queue a runGDCMatrix() job on this session, with the session grid cache.
+     */
+    std::future<int> runGDCMatrix(const BufferData& dst, const BufferData& src, const short* affine,
+                                  int format = PIXEL_FORMAT_YUV_420_SP, int target = TARGET_GDC_HW,
+                                  Callback callback = nullptr);
+
+    /**
+     * @brief Queue a bicubic SW scaler job on this session.
+     */
+    std::future<int> runInterpBicubic(const BufferData& dst, const BufferData& src,
+                                      int format = PIXEL_FORMAT_YUV_420_SP, Callback callback = nullptr);
+
+    /**
+     * @brief Wait until every job queued on this session has completed.
+     */
+    void waitIdle();
+
+    /**
+     * @brief Buffers of this session, on its own ION client.
+     */
+    BufferPool& buffers() { return *mBuffers; }
+
+private:
+    GeoTransSession();
+
+    std::future<int> submit(int id, std::function<int()> run, Callback callback);
+
+    std::unique_ptr<GeoTransEngine> mEngines[ENGINE_COUNT];
+    std::unique_ptr<BufferPool> mBuffers;
+    GDCGridCache mGrids;
+};
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
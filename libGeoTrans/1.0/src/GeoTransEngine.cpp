@@ -0,0 +1,81 @@
+#define LOG_TAG "GeoTrans"
+
+#include <algorithm>
+
+#include <cutils/properties.h>
+#include <log/log.h>
+
+#include "GeoTransEngine.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+GeoTransEngine::GeoTransEngine(const char* name, size_t depth)
+    : mName(name), mDepth(std::max<size_t>(1, depth)), mBusy(false), mStop(false)
+{
+    mThread = std::thread(&GeoTransEngine::threadLoop, this);
+}
+
+GeoTransEngine::~GeoTransEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mCond.notify_all();
+
+    mThread.join();
+}
+
+void GeoTransEngine::post(std::function<void()> job)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    mSpaceCond.wait(lock, [this] { return mJobs.size() < mDepth; });
+    mJobs.push_back(std::move(job));
+
+    lock.unlock();
+    mCond.notify_all();
+}
+
+void GeoTransEngine::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    mSpaceCond.wait(lock, [this] { return mJobs.empty() && !mBusy; });
+}
+
+void GeoTransEngine::threadLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (true) {
+        mCond.wait(lock, [this] { return mStop || !mJobs.empty(); });
+
+        // Queued jobs still run on stop so that no future is left unset.
+        if (mJobs.empty())
+            break;
+
+        std::function<void()> job = std::move(mJobs.front());
+        mJobs.pop_front();
+        mBusy = true;
+
+        lock.unlock();
+        mSpaceCond.notify_all();
+        job();
+        lock.lock();
+
+        mBusy = false;
+        mSpaceCond.notify_all();
+    }
+
+    ALOGV("%s engine stopped", mName);
+}
+
+size_t GeoTransEngine::defaultDepth()
+{
+    return std::max(1, property_get_int32("ro.vendor.geotrans.queue_depth", 4));
+}
+
+} // namespace geoTransClient
+} // namespace hardware
@@ -0,0 +1,55 @@
+#ifndef GEO_TRANS_ENGINE_H
+#define GEO_TRANS_ENGINE_H
+
+#include <stddef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief One worker thread with a bounded FIFO of jobs.
+ */
+class GeoTransEngine {
+public:
+    GeoTransEngine(const char* name, size_t depth);
+    ~GeoTransEngine();
+
+    /**
+     * @brief Queue a job, blocking while the queue is full.
+     */
+    void post(std::function<void()> job);
+
+    /**
+     * @brief Wait until the queue is empty and no job is running.
+     */
+    void waitIdle();
+
+    /**
+     * @brief Queue depth from ro.vendor.geotrans.queue_depth.
+     */
+    static size_t defaultDepth();
+
+private:
+    void threadLoop();
+
+    const char* mName;
+    const size_t mDepth;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::condition_variable mSpaceCond;
+    std::deque<std::function<void()>> mJobs;
+    bool mBusy;
+    bool mStop;
+    std::thread mThread;
+};
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
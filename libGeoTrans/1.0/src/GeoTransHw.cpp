@@ -0,0 +1,81 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+
+#include <mutex>
+
+#include <log/log.h>
+
+#include "GeoTransHw.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+std::mutex gCSCLock;
+std::mutex gGDCLock;
+
+std::mutex gClientLock;
+int gClientRefs = 0;
+
+} // namespace
+
+int hwRunCSC(BufferData& dst, BufferData& src, int format)
+{
+    std::lock_guard<std::mutex> lock(gCSCLock);
+    return runCSC(dst, src, format);
+}
+
+int hwRunGDCGrid(BufferData& dst, BufferData& src, GDCGrid& grid, int format, int target)
+{
+    std::lock_guard<std::mutex> lock(gGDCLock);
+    return runGDCGrid(dst, src, grid, format, target);
+}
+
+int hwAcquireClient()
+{
+    std::lock_guard<std::mutex> lock(gClientLock);
+
+    if (gClientRefs == 0) {
+        int ret = init();
+        if (ret) {
+            ALOGE("init() failed (%d)", ret);
+            return ret;
+        }
+    }
+
+    gClientRefs++;
+    return 0;
+}
+
+int hwRetainClient()
+{
+    std::lock_guard<std::mutex> lock(gClientLock);
+
+    if (gClientRefs == 0) {
+        ALOGE("no shared client, call initShared() or create a session first");
+        return -ENODEV;
+    }
+
+    gClientRefs++;
+    return 0;
+}
+
+int hwReleaseClient()
+{
+    std::lock_guard<std::mutex> lock(gClientLock);
+
+    if (gClientRefs == 0) {
+        ALOGE("client released more often than acquired");
+        return -EINVAL;
+    }
+
+    if (--gClientRefs == 0)
+        return deinit();
+
+    return 0;
+}
+
+} // namespace geoTransClient
+} // namespace hardware
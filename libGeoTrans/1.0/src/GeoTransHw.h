@@ -0,0 +1,35 @@
+#ifndef GEO_TRANS_HW_H
+#define GEO_TRANS_HW_H
+
+#include "geo_trans_interface.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief Calls into the libGeoTrans10 HW blocks.
+ *
+ * The prebuilt client keeps the state of each block in globals, so calls
+ * on one block are serialized here. The CSC and GDC blocks have separate
+ * state and still run concurrently. Everything in this library that
+ * reaches the HW goes through these.
+ */
+int hwRunCSC(BufferData& dst, BufferData& src, int format);
+int hwRunGDCGrid(BufferData& dst, BufferData& src, GDCGrid& grid, int format, int target);
+
+/**
+ * @brief References on the process-wide client.
+ *
+ * Sessions, queued async jobs and initShared() callers each hold one; the
+ * first reference calls init() and the last one released calls deinit().
+ * hwRetainClient() never calls init(): it only adds to a reference already
+ * held, and fails with -ENODEV otherwise.
+ * @return[output] 0, the init() status, or -ENODEV
+ */
+int hwAcquireClient();
+int hwRetainClient();
+int hwReleaseClient();
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
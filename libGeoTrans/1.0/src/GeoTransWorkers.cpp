@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <atomic>
+
+#include "GeoTransWorkers.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+constexpr int MAX_SHARED_THREADS = 4;
+
+} // namespace
+
+struct GeoTransWorkers::Call {
+    Call(const std::function<void(int)>& item, int count) : item(item), count(count), next(0), done(0) {}
+
+    // Take items until none is left.
+    void work()
+    {
+        int ran = 0;
+        for (int i = next++; i < count; i = next++) {
+            item(i);
+            ran++;
+        }
+
+        if (!ran)
+            return;
+
+        std::lock_guard<std::mutex> guard(lock);
+        done += ran;
+        if (done == count)
+            cond.notify_all();
+    }
+
+    // Only used while items are left, that is while run() still waits.
+    const std::function<void(int)>& item;
+    const int count;
+    std::atomic<int> next;
+
+    std::mutex lock;
+    std::condition_variable cond;
+    int done;
+};
+
+GeoTransWorkers::GeoTransWorkers(int threads)
+    : mStop(false)
+{
+    for (int t = 1; t < threads; t++)
+        mThreads.emplace_back(&GeoTransWorkers::threadLoop, this);
+}
+
+GeoTransWorkers::~GeoTransWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mCond.notify_all();
+
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+void GeoTransWorkers::run(int count, int maxThreads, const std::function<void(int)>& item)
+{
+    int helpers = std::min({ maxThreads - 1, threads() - 1, count - 1 });
+    if (helpers <= 0) {
+        for (int i = 0; i < count; i++)
+            item(i);
+        return;
+    }
+
+    auto call = std::make_shared<Call>(item, count);
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        for (int h = 0; h < helpers; h++)
+            mCalls.push_back(call);
+    }
+    if (helpers == 1)
+        mCond.notify_one();
+    else
+        mCond.notify_all();
+
+    call->work();
+
+    {
+        std::unique_lock<std::mutex> lock(call->lock);
+        call->cond.wait(lock, [&call] { return call->done == call->count; });
+    }
+
+    // Workers that did not get to this call yet have nothing left to do in it.
+    std::lock_guard<std::mutex> lock(mLock);
+    mCalls.erase(std::remove(mCalls.begin(), mCalls.end(), call), mCalls.end());
+}
+
+void GeoTransWorkers::threadLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (true) {
+        mCond.wait(lock, [this] { return mStop || !mCalls.empty(); });
+
+        if (mStop)
+            break;
+
+        std::shared_ptr<Call> call = std::move(mCalls.front());
+        mCalls.pop_front();
+
+        lock.unlock();
+        call->work();
+        lock.lock();
+    }
+}
+
+GeoTransWorkers& GeoTransWorkers::shared()
+{
+    // Never destroyed, like the engines, so that SW jobs can run until exit.
+    static GeoTransWorkers* workers = new GeoTransWorkers(
+        std::min<int>(MAX_SHARED_THREADS, std::max(1u, std::thread::hardware_concurrency())));
+
+    return *workers;
+}
+
+} // namespace geoTransClient
+} // namespace hardware
@@ -0,0 +1,61 @@
+#ifndef GEO_TRANS_WORKERS_H
+#define GEO_TRANS_WORKERS_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hardware {
+namespace geoTransClient {
+
+/**
+ * @brief Worker threads shared by the SW paths.
+ *
+ * run() splits a call into items that the calling thread and idle workers
+ * take in order. It returns once every item is done, without waiting for
+ * workers that are busy elsewhere, so concurrent calls never block on
+ * each other.
+ */
+class GeoTransWorkers {
+public:
+    explicit GeoTransWorkers(int threads);
+    ~GeoTransWorkers();
+
+    GeoTransWorkers(const GeoTransWorkers&) = delete;
+    GeoTransWorkers& operator=(const GeoTransWorkers&) = delete;
+
+    /**
+     * @brief Run item(0) to item(count - 1) on at most maxThreads threads,
+     * the calling one included.
+     */
+    void run(int count, int maxThreads, const std::function<void(int)>& item);
+
+    /**
+     * @brief Threads that can work on one call, the calling one included.
+     */
+    int threads() const { return static_cast<int>(mThreads.size()) + 1; }
+
+    /**
+     * @brief Process-wide workers, one per core up to four cores.
+     */
+    static GeoTransWorkers& shared();
+
+private:
+    struct Call;
+
+    void threadLoop();
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::deque<std::shared_ptr<Call>> mCalls;   // one entry per worker asked to help
+    bool mStop;
+    std::vector<std::thread> mThreads;
+};
+
+} // namespace geoTransClient
+} // namespace hardware
+#endif
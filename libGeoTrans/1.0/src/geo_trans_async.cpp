@@ -0,0 +1,110 @@
+#define LOG_TAG "GeoTrans"
+
+#include <string.h>
+
+#include <array>
+#include <memory>
+#include <mutex>
+
+#include <log/log.h>
+
+#include "geo_trans_async.h"
+#include "geo_trans_gdc.h"
+#include "geo_trans_grid.h"
+#include "GeoTransEngine.h"
+#include "GeoTransHw.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+GeoTransEngine& engine(int id)
+{
+    static const char* names[ENGINE_COUNT] = { "csc", "gdc", "bicubic" };
+    static GeoTransEngine* engines[ENGINE_COUNT];
+    static std::once_flag once;
+
+    // Never destroyed, jobs may still reference the client library at exit.
+    std::call_once(once, [] {
+        for (int i = 0; i < ENGINE_COUNT; i++)
+            engines[i] = new GeoTransEngine(names[i], GeoTransEngine::defaultDepth());
+    });
+
+    return *engines[id];
+}
+
+std::future<int> submit(int id, std::function<int()> run, Callback callback)
+{
+    auto promise = std::make_shared<std::promise<int>>();
+    std::future<int> future = promise->get_future();
+
+    // Keeps the last session from calling deinit() under a queued job. Only
+    // borrows a reference, so a job never brings up or tears down the client.
+    int ret = hwRetainClient();
+    if (ret) {
+        if (callback)
+            callback(ret);
+        promise->set_value(ret);
+        return future;
+    }
+
+    engine(id).post([run, callback, promise]() {
+        int status = run();
+        hwReleaseClient();
+        if (callback)
+            callback(status);
+        promise->set_value(status);
+    });
+
+    return future;
+}
+
+} // namespace
+
+std::future<int> runCSCAsync(const BufferData& dst, const BufferData& src, int format, Callback callback)
+{
+    return submit(ENGINE_CSC, [dst = dst, src = src, format]() mutable {
+        return hwRunCSC(dst, src, format);
+    }, callback);
+}
+
+std::future<int> runGDCGridAsync(const BufferData& dst, const BufferData& src, const GDCGrid& grid,
+                                 int format, int target, Callback callback)
+{
+    auto copy = std::make_shared<GDCGrid>(grid);
+
+    return submit(ENGINE_GDC, [dst = dst, src = src, copy, format, target]() mutable {
+        // As in GeoTransSession, the prebuilt C model shares the GDC globals.
+        if (target == TARGET_GDC_C_MODEL)
+            return runGDCGridTiled(dst, src, *copy, format);
+        return hwRunGDCGrid(dst, src, *copy, format, target);
+    }, callback);
+}
+
+std::future<int> runGDCMatrixAsync(const BufferData& dst, const BufferData& src, const short* affine,
+                                   int format, int target, Callback callback)
+{
+    std::array<short, 6> matrix;
+    memcpy(matrix.data(), affine, sizeof(short) * matrix.size());
+
+    return submit(ENGINE_GDC, [dst = dst, src = src, matrix, format, target]() mutable {
+        return runGDCMatrixCached(dst, src, matrix.data(), format, target);
+    }, callback);
+}
+
+std::future<int> runInterpBicubicAsync(const BufferData& dst, const BufferData& src, int format, Callback callback)
+{
+    return submit(ENGINE_BICUBIC, [dst = dst, src = src, format]() mutable {
+        return runInterpBicubic(dst, src, format);
+    }, callback);
+}
+
+void waitIdle()
+{
+    for (int i = 0; i < ENGINE_COUNT; i++)
+        engine(i).waitIdle();
+}
+
+} // namespace geoTransClient
+} // namespace hardware
@@ -0,0 +1,145 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+#include <string.h>
+
+#include <future>
+
+#include <log/log.h>
+
+#include "geo_trans_async.h"
+#include "geo_trans_batch.h"
+#include "geo_trans_buffer_pool.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+std::vector<int> waitAll(std::vector<std::future<int>>& futures)
+{
+    std::vector<int> status(futures.size());
+
+    for (size_t i = 0; i < futures.size(); i++)
+        status[i] = futures[i].valid() ? futures[i].get() : -EINVAL;
+
+    return status;
+}
+
+BufferPool& stagingPool()
+{
+    static BufferPool* pool = [] {
+        std::shared_ptr<BufferAllocator> allocator = createIonAllocator();
+        if (!allocator) {
+            ALOGW("no ion, batch sources are not staged");
+            allocator = createHeapAllocator();
+        }
+        return new BufferPool(allocator);
+    }();
+
+    return *pool;
+}
+
+// CPU source copied once into a pooled dma-buf, released on scope exit.
+class StagedSource {
+public:
+    StagedSource(const BufferData& src, int format) : mStatus(-ENOENT)
+    {
+        if (src.fdY >= 0 || !src.y || (format == PIXEL_FORMAT_YUV_420_SP && !src.uv))
+            return;
+
+        mStatus = stagingPool().acquire(mBuffer, src.width, src.height, BUFFER_USAGE_CSC, format);
+        if (mStatus)
+            return;
+
+        // Only worth it when the HW can take the copy as is.
+        if (mBuffer.fdY < 0 || mBuffer.width != src.width || mBuffer.height != src.height) {
+            stagingPool().release(mBuffer);
+            mStatus = -ENOENT;
+            return;
+        }
+
+        size_t lumaSize = static_cast<size_t>(src.width) * src.height;
+        memcpy(mBuffer.y, src.y, lumaSize);
+        if (format == PIXEL_FORMAT_YUV_420_SP)
+            memcpy(mBuffer.uv, src.uv, lumaSize / 2);
+
+        mBuffer.fov = src.fov;
+    }
+
+    ~StagedSource()
+    {
+        if (mStatus == 0)
+            stagingPool().release(mBuffer);
+    }
+
+    bool staged() const { return mStatus == 0; }
+
+    // By fd only, so that no job maps or copies it again.
+    BufferData deviceOnly() const
+    {
+        BufferData device = mBuffer;
+        device.y = NULL;
+        device.uv = NULL;
+        return device;
+    }
+
+private:
+    BufferData mBuffer;
+    int mStatus;
+};
+
+} // namespace
+
+std::vector<int> runCSCBatch(std::vector<BufferData>& dsts, BufferData& src, int format)
+{
+    // The HW path copies a CPU source into ION on every call, stage it
+    // once for all destinations instead.
+    StagedSource staged(src, format);
+    BufferData source = staged.staged() ? staged.deviceOnly() : src;
+
+    std::vector<std::future<int>> futures;
+    futures.reserve(dsts.size());
+
+    for (BufferData& dst : dsts)
+        futures.push_back(runCSCAsync(dst, source, format));
+
+    // The staged buffer must outlive the jobs.
+    return waitAll(futures);
+}
+
+std::vector<int> runBatch(std::vector<GeoTransJob>& jobs)
+{
+    std::vector<std::future<int>> futures(jobs.size());
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        GeoTransJob& job = jobs[i];
+
+        switch (job.type) {
+        case JOB_CSC:
+            futures[i] = runCSCAsync(job.dst, job.src, job.format);
+            break;
+        case JOB_GDC_GRID:
+            if (job.grid)
+                futures[i] = runGDCGridAsync(job.dst, job.src, *job.grid, job.format, job.target);
+            break;
+        case JOB_GDC_MATRIX:
+            if (job.affine)
+                futures[i] = runGDCMatrixAsync(job.dst, job.src, job.affine, job.format, job.target);
+            break;
+        case JOB_INTERP_BICUBIC:
+            futures[i] = runInterpBicubicAsync(job.dst, job.src, job.format);
+            break;
+        default:
+            break;
+        }
+
+        if (!futures[i].valid())
+            ALOGE("invalid batch job %zu of type %d", i, job.type);
+    }
+
+    return waitAll(futures);
+}
+
+} // namespace geoTransClient
+} // namespace hardware
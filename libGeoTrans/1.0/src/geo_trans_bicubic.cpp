@@ -0,0 +1,246 @@
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "geo_trans_bicubic.h"
+#include "GeoTransWorkers.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+constexpr int PHASE_BITS = 6;
+constexpr int PHASES = 1 << PHASE_BITS;
+constexpr int COEFF_BITS = 6;       // taps sum to 64
+constexpr int TAPS = 4;
+constexpr int MIN_SRC = 16;
+constexpr int MIN_DST = 4;
+constexpr int MAX_SIZE = 8192;
+constexpr int MAX_THREADS = 4;
+constexpr int MIN_STRIPE_ROWS = 32;
+
+/**
+ * Catmull-Rom taps for every 1/64 phase, rounded so that each set sums
+ * to exactly 1 << COEFF_BITS.
+ */
+struct PhaseTable {
+    int16_t taps[PHASES][TAPS];
+
+    PhaseTable() {
+        for (int phase = 0; phase < PHASES; phase++) {
+            double t = static_cast<double>(phase) / PHASES;
+            double w[TAPS] = {
+                ((-0.5 * t + 1.0) * t - 0.5) * t,
+                (1.5 * t - 2.5) * t * t + 1.0,
+                ((-1.5 * t + 2.0) * t + 0.5) * t,
+                (0.5 * t - 0.5) * t * t,
+            };
+
+            int sum = 0;
+            for (int i = 0; i < TAPS; i++) {
+                taps[phase][i] = static_cast<int16_t>(w[i] * (1 << COEFF_BITS) + (w[i] < 0 ? -0.5 : 0.5));
+                sum += taps[phase][i];
+            }
+            // Put the rounding error on the largest tap.
+            taps[phase][t < 0.5 ? 1 : 2] += (1 << COEFF_BITS) - sum;
+        }
+    }
+};
+
+const PhaseTable& phaseTable()
+{
+    static const PhaseTable table;
+    return table;
+}
+
+/**
+ * Source taps and weights of every destination sample along one axis.
+ * Positions follow runInterpBicubic(): dst * ((src << 6) / dst) in 1/64.
+ * Taps outside the image are clamped to the edge.
+ */
+struct AxisTable {
+    std::vector<int32_t> index;     // TAPS per destination sample
+    std::vector<int16_t> coeff;     // TAPS per destination sample
+
+    AxisTable(int srcSize, int dstSize) : index(dstSize * TAPS), coeff(dstSize * TAPS) {
+        const PhaseTable& table = phaseTable();
+        int64_t step = (static_cast<int64_t>(srcSize) << PHASE_BITS) / dstSize;
+
+        for (int d = 0; d < dstSize; d++) {
+            int64_t pos = d * step;
+            int base = static_cast<int>(pos >> PHASE_BITS);
+            int phase = static_cast<int>(pos & (PHASES - 1));
+
+            for (int i = 0; i < TAPS; i++) {
+                index[d * TAPS + i] = std::min(std::max(base - 1 + i, 0), srcSize - 1);
+                coeff[d * TAPS + i] = table.taps[phase][i];
+            }
+        }
+    }
+};
+
+// One plane of width x height samples, each sample made of channels interleaved bytes.
+struct Plane {
+    const uint8_t* src;
+    uint8_t* dst;
+    int srcWidth;
+    int srcHeight;
+    int dstWidth;
+    int dstHeight;
+    int channels;
+};
+
+void filterRow(const uint8_t* src, int16_t* out, const AxisTable& xs, int dstWidth, int channels)
+{
+    const int32_t* index = xs.index.data();
+    const int16_t* coeff = xs.coeff.data();
+
+    for (int d = 0; d < dstWidth; d++, index += TAPS, coeff += TAPS) {
+        for (int c = 0; c < channels; c++) {
+            int sum = coeff[0] * src[index[0] * channels + c] +
+                      coeff[1] * src[index[1] * channels + c] +
+                      coeff[2] * src[index[2] * channels + c] +
+                      coeff[3] * src[index[3] * channels + c];
+            out[d * channels + c] = static_cast<int16_t>(sum);
+        }
+    }
+}
+
+inline uint8_t clampPixel(int value)
+{
+    return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+}
+
+void filterColumn(const int16_t* const rows[TAPS], const int16_t* coeff, uint8_t* dst, int count)
+{
+    constexpr int SHIFT = COEFF_BITS * 2;
+    constexpr int ROUND = 1 << (SHIFT - 1);
+    int i = 0;
+
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t r0 = vld1q_s16(rows[0] + i), r1 = vld1q_s16(rows[1] + i);
+        int16x8_t r2 = vld1q_s16(rows[2] + i), r3 = vld1q_s16(rows[3] + i);
+
+        int32x4_t lo = vmull_n_s16(vget_low_s16(r0), coeff[0]);
+        lo = vmlal_n_s16(lo, vget_low_s16(r1), coeff[1]);
+        lo = vmlal_n_s16(lo, vget_low_s16(r2), coeff[2]);
+        lo = vmlal_n_s16(lo, vget_low_s16(r3), coeff[3]);
+        int32x4_t hi = vmull_n_s16(vget_high_s16(r0), coeff[0]);
+        hi = vmlal_n_s16(hi, vget_high_s16(r1), coeff[1]);
+        hi = vmlal_n_s16(hi, vget_high_s16(r2), coeff[2]);
+        hi = vmlal_n_s16(hi, vget_high_s16(r3), coeff[3]);
+
+        int16x8_t sum = vcombine_s16(vrshrn_n_s32(lo, SHIFT), vrshrn_n_s32(hi, SHIFT));
+        vst1_u8(dst + i, vqmovun_s16(sum));
+    }
+#elif defined(__SSE2__)
+    const __m128i c01 = _mm_set1_epi32((coeff[1] << 16) | (coeff[0] & 0xffff));
+    const __m128i c23 = _mm_set1_epi32((coeff[3] << 16) | (coeff[2] & 0xffff));
+    const __m128i round = _mm_set1_epi32(ROUND);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[0] + i));
+        __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[1] + i));
+        __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[2] + i));
+        __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[3] + i));
+
+        __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(r0, r1), c01),
+                                   _mm_madd_epi16(_mm_unpacklo_epi16(r2, r3), c23));
+        __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(r0, r1), c01),
+                                   _mm_madd_epi16(_mm_unpackhi_epi16(r2, r3), c23));
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, round), SHIFT);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, round), SHIFT);
+
+        __m128i sum = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(sum, sum));
+    }
+#endif
+
+    for (; i < count; i++) {
+        int sum = coeff[0] * rows[0][i] + coeff[1] * rows[1][i] + coeff[2] * rows[2][i] + coeff[3] * rows[3][i];
+        dst[i] = clampPixel((sum + ROUND) >> SHIFT);
+    }
+}
+
+void scaleStripe(const Plane& plane, const AxisTable& xs, const AxisTable& ys, int begin, int end)
+{
+    const int count = plane.dstWidth * plane.channels;
+
+    // Horizontally filtered source rows, reused while consecutive output rows share them.
+    std::vector<int16_t> cache(TAPS * count);
+    int cached[TAPS] = { -1, -1, -1, -1 };
+
+    for (int d = begin; d < end; d++) {
+        const int32_t* index = &ys.index[d * TAPS];
+        const int16_t* rows[TAPS];
+
+        for (int i = 0; i < TAPS; i++) {
+            int slot = index[i] % TAPS;
+            if (cached[slot] != index[i]) {
+                filterRow(plane.src + static_cast<size_t>(index[i]) * plane.srcWidth * plane.channels,
+                          &cache[slot * count], xs, plane.dstWidth, plane.channels);
+                cached[slot] = index[i];
+            }
+            rows[i] = &cache[slot * count];
+        }
+
+        filterColumn(rows, &ys.coeff[d * TAPS], plane.dst + static_cast<size_t>(d) * count, count);
+    }
+}
+
+void scalePlane(const Plane& plane)
+{
+    AxisTable xs(plane.srcWidth, plane.dstWidth);
+    AxisTable ys(plane.srcHeight, plane.dstHeight);
+
+    GeoTransWorkers& workers = GeoTransWorkers::shared();
+    int threads = std::min(MAX_THREADS, workers.threads());
+    threads = std::max(1, std::min(threads, plane.dstHeight / MIN_STRIPE_ROWS));
+
+    int rows = (plane.dstHeight + threads - 1) / threads;
+    workers.run(threads, threads, [&plane, &xs, &ys, rows](int stripe) {
+        int begin = stripe * rows;
+        scaleStripe(plane, xs, ys, begin, std::min(plane.dstHeight, begin + rows));
+    });
+}
+
+} // namespace
+
+int runInterpBicubicFast(BufferData& dst, BufferData& src, int format)
+{
+    if (format != PIXEL_FORMAT_Y_GRAY && format != PIXEL_FORMAT_YUV_420_SP)
+        return -EINVAL;
+
+    if (!src.y || !dst.y || (format == PIXEL_FORMAT_YUV_420_SP && (!src.uv || !dst.uv)))
+        return -EINVAL;
+
+    if (src.width < MIN_SRC || src.height < MIN_SRC || src.width > MAX_SIZE || src.height > MAX_SIZE ||
+        dst.width < MIN_DST || dst.height < MIN_DST || dst.width > MAX_SIZE || dst.height > MAX_SIZE)
+        return -EINVAL;
+
+    if (format == PIXEL_FORMAT_YUV_420_SP && ((src.width | src.height | dst.width | dst.height) & 1))
+        return -EINVAL;
+
+    Plane luma = { src.y, dst.y, src.width, src.height, dst.width, dst.height, 1 };
+    scalePlane(luma);
+
+    if (format == PIXEL_FORMAT_YUV_420_SP) {
+        Plane chroma = { src.uv, dst.uv, src.width / 2, src.height / 2, dst.width / 2, dst.height / 2, 2 };
+        scalePlane(chroma);
+    }
+
+    return 0;
+}
+
+} // namespace geoTransClient
+} // namespace hardware
@@ -0,0 +1,222 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include <log/log.h>
+
+#include "geo_trans_buffer_pool.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+constexpr int CSC_ALIGN = 2;
+constexpr int GDC_ALIGN = 16;
+constexpr int MAX_SIZE = 8192;
+constexpr size_t PAGE_SIZE_BYTES = 4096;
+constexpr int CLASSES_PER_OCTAVE = 4;
+
+inline int alignUp(int value, int align)
+{
+    return (value + align - 1) / align * align;
+}
+
+class HeapAllocator : public BufferAllocator {
+public:
+    int allocate(size_t size, int* fd, unsigned char** addr) override
+    {
+        void* block = nullptr;
+        if (posix_memalign(&block, PAGE_SIZE_BYTES, size))
+            return -ENOMEM;
+
+        *fd = -1;
+        *addr = static_cast<unsigned char*>(block);
+        return 0;
+    }
+
+    void free(size_t, int, unsigned char* addr) override
+    {
+        ::free(addr);
+    }
+};
+
+} // namespace
+
+std::shared_ptr<BufferAllocator> createHeapAllocator()
+{
+    return std::make_shared<HeapAllocator>();
+}
+
+BufferPool::BufferPool(std::shared_ptr<BufferAllocator> allocator, size_t maxCachedBytes)
+    : mAllocator(std::move(allocator)), mMaxCachedBytes(maxCachedBytes), mCachedBytes(0)
+{
+}
+
+BufferPool::~BufferPool()
+{
+    trim();
+
+    // Buffers still out may be in use by a job or the HW, so they are left
+    // alone. Leaking them beats freeing memory under a running job.
+    if (!mInUse.empty()) {
+        size_t bytes = 0;
+        for (auto& entry : mInUse)
+            bytes += entry.second.size;
+        ALOGE("destroyed with %zu planes (%zu bytes) not released, leaking them", mInUse.size(), bytes);
+    }
+}
+
+size_t BufferPool::sizeClass(size_t size)
+{
+    size = std::max(size, PAGE_SIZE_BYTES);
+
+    // Four classes per power of two keep the waste under 25%.
+    size_t octave = PAGE_SIZE_BYTES;
+    while (octave * 2 < size)
+        octave *= 2;
+
+    size_t step = std::max(PAGE_SIZE_BYTES, octave / CLASSES_PER_OCTAVE);
+    return (size + step - 1) / step * step;
+}
+
+int BufferPool::take(size_t size, Block* block)
+{
+    size_t cls = sizeClass(size);
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        // Most recently released first, it is the most likely to be in cache.
+        for (auto it = mFree.rbegin(); it != mFree.rend(); ++it) {
+            if (it->size == cls) {
+                *block = *it;
+                mCachedBytes -= it->size;
+                mFree.erase(std::next(it).base());
+                mInUse[block->addr] = *block;
+                return 0;
+            }
+        }
+    }
+
+    block->size = cls;
+    int ret = mAllocator->allocate(cls, &block->fd, &block->addr);
+    if (ret)
+        return ret;
+
+    std::lock_guard<std::mutex> lock(mLock);
+    mInUse[block->addr] = *block;
+    return 0;
+}
+
+void BufferPool::give(const Block& block)
+{
+    std::list<Block> freed;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mFree.push_back(block);
+        mCachedBytes += block.size;
+
+        while (mCachedBytes > mMaxCachedBytes && !mFree.empty()) {
+            mCachedBytes -= mFree.front().size;
+            freed.splice(freed.end(), mFree, mFree.begin());
+        }
+    }
+
+    for (auto& victim : freed)
+        mAllocator->free(victim.size, victim.fd, victim.addr);
+}
+
+int BufferPool::acquire(BufferData& buffer, int width, int height, int usage, int format)
+{
+    if (usage != BUFFER_USAGE_CSC && usage != BUFFER_USAGE_GDC)
+        return -EINVAL;
+
+    if (format != PIXEL_FORMAT_Y_GRAY && format != PIXEL_FORMAT_YUV_420_SP)
+        return -EINVAL;
+
+    if (width <= 0 || height <= 0 || width > MAX_SIZE || height > MAX_SIZE)
+        return -EINVAL;
+
+    int align = usage == BUFFER_USAGE_GDC ? GDC_ALIGN : CSC_ALIGN;
+    int alignedWidth = alignUp(width, align);
+    int alignedHeight = alignUp(height, align);
+    size_t lumaSize = static_cast<size_t>(alignedWidth) * alignedHeight;
+
+    Block luma;
+    int ret = take(lumaSize, &luma);
+    if (ret)
+        return ret;
+
+    Block chroma = { 0, -1, nullptr };
+    if (format == PIXEL_FORMAT_YUV_420_SP) {
+        ret = take(lumaSize / 2, &chroma);
+        if (ret) {
+            BufferData partial;
+            partial.y = luma.addr;
+            release(partial);
+            return ret;
+        }
+    }
+
+    buffer = BufferData();
+    buffer.y = luma.addr;
+    buffer.uv = chroma.addr;
+    buffer.fdY = luma.fd;
+    buffer.fdUV = chroma.fd;
+    buffer.width = alignedWidth;
+    buffer.height = alignedHeight;
+    buffer.fov.r = width;
+    buffer.fov.b = height;
+
+    return 0;
+}
+
+void BufferPool::release(BufferData& buffer)
+{
+    unsigned char* planes[] = { buffer.y, buffer.uv };
+
+    for (unsigned char* addr : planes) {
+        if (!addr)
+            continue;
+
+        Block block;
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            auto it = mInUse.find(addr);
+            if (it == mInUse.end())
+                continue;
+            block = it->second;
+            mInUse.erase(it);
+        }
+        give(block);
+    }
+
+    buffer = BufferData();
+}
+
+void BufferPool::trim()
+{
+    std::list<Block> freed;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        freed.swap(mFree);
+        mCachedBytes = 0;
+    }
+
+    for (auto& victim : freed)
+        mAllocator->free(victim.size, victim.fd, victim.addr);
+}
+
+size_t BufferPool::cachedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCachedBytes;
+}
+
+} // namespace geoTransClient
+} // namespace hardware
@@ -0,0 +1,324 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#include <linux/dma-buf.h>
+#include <linux/magic.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <log/log.h>
+
+#include "geo_trans_bicubic.h"
+#include "geo_trans_fd.h"
+#include "geo_trans_gdc.h"
+#include "GeoTransHw.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+constexpr size_t MAX_IMPORTS = 16;
+
+#ifndef DMA_BUF_MAGIC
+#define DMA_BUF_MAGIC 0x444d4142
+#endif
+
+// st_size is 0 for dma-bufs on older kernels, the size comes from seeking
+// to the end then. The offset is shared with the caller, so it is put back.
+int64_t bufferSize(int fd, const struct stat* st)
+{
+    if (st && st->st_size > 0)
+        return st->st_size;
+
+    off_t pos = lseek(fd, 0, SEEK_CUR);
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (pos >= 0)
+        lseek(fd, pos, SEEK_SET);
+
+    return size;
+}
+
+// Only dma-bufs on their own filesystem have an inode each, older kernels
+// put all of them on the one anon inode.
+bool hasOwnInode(int fd)
+{
+    struct statfs fs;
+    return !fstatfs(fd, &fs) && fs.f_type == DMA_BUF_MAGIC;
+}
+
+// CPU mapping of a whole dma-buf, unmapped with the last reference.
+struct Mapping {
+    Mapping(unsigned char* a, size_t s) : addr(a), size(s) {}
+    ~Mapping() { munmap(addr, size); }
+
+    unsigned char* const addr;
+    const size_t size;
+};
+
+struct Import {
+    dev_t dev;
+    ino_t ino;
+    int64_t size;
+    std::shared_ptr<Mapping> mapping;   // made by the first SW fallback
+};
+
+/**
+ * dma-bufs seen by the fd-only API, by inode so that every fd of a buffer
+ * shares one entry. The size is kept for the checks of every call, HW or
+ * SW, and the mapping once the SW path needed it. Buffers without an
+ * inode of their own cannot be told apart and are measured and mapped
+ * for each call instead.
+ */
+class ImportCache {
+public:
+    int64_t size(int fd)
+    {
+        struct stat st;
+        if (!cacheable(fd, st))
+            return bufferSize(fd, NULL);
+
+        // Evicted mappings are unmapped once the lock is dropped.
+        std::list<Import> evicted;
+        std::lock_guard<std::mutex> lock(mLock);
+        return findLocked(fd, st, evicted)->size;
+    }
+
+    std::shared_ptr<Mapping> map(int fd)
+    {
+        struct stat st;
+        if (!cacheable(fd, st))
+            return mapWhole(fd, bufferSize(fd, NULL));
+
+        std::list<Import> evicted;
+        int64_t size;
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            auto it = findLocked(fd, st, evicted);
+            if (it->mapping)
+                return it->mapping;
+            size = it->size;
+        }
+
+        // Mapped without the lock, another caller may have mapped it meanwhile.
+        std::shared_ptr<Mapping> mapping = mapWhole(fd, size);
+        if (!mapping)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(mLock);
+        auto it = findLocked(fd, st, evicted);
+        if (!it->mapping)
+            it->mapping = mapping;
+        return it->mapping;
+    }
+
+    void clear()
+    {
+        std::list<Import> evicted;
+
+        std::lock_guard<std::mutex> lock(mLock);
+        evicted.swap(mEntries);
+    }
+
+private:
+    static bool cacheable(int fd, struct stat& st)
+    {
+        return hasOwnInode(fd) && !fstat(fd, &st);
+    }
+
+    static std::shared_ptr<Mapping> mapWhole(int fd, int64_t size)
+    {
+        if (size <= 0) {
+            ALOGE("failed to get the size of fd %d (%d)", fd, errno);
+            return nullptr;
+        }
+
+        void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            ALOGE("failed to map fd %d (%d)", fd, errno);
+            return nullptr;
+        }
+
+        return std::make_shared<Mapping>(static_cast<unsigned char*>(addr), size);
+    }
+
+    // Moves the entry of the buffer to the front, adding it if new. Only a
+    // mapping holds its buffer, so an entry without one is refreshed when
+    // fstat tells of another buffer on a reused inode.
+    std::list<Import>::iterator findLocked(int fd, const struct stat& st, std::list<Import>& evicted)
+    {
+        for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+            if (it->dev == st.st_dev && it->ino == st.st_ino) {
+                if (st.st_size > 0 && st.st_size != it->size) {
+                    it->size = st.st_size;
+                    it->mapping.reset();
+                }
+                mEntries.splice(mEntries.begin(), mEntries, it);
+                return mEntries.begin();
+            }
+        }
+
+        mEntries.push_front(Import{ st.st_dev, st.st_ino, bufferSize(fd, &st), nullptr });
+        if (mEntries.size() > MAX_IMPORTS)
+            evicted.splice(evicted.end(), mEntries, std::prev(mEntries.end()));
+
+        return mEntries.begin();
+    }
+
+    std::mutex mLock;
+    std::list<Import> mEntries;     // most recent first
+};
+
+ImportCache& importCache()
+{
+    static ImportCache* cache = new ImportCache();
+    return *cache;
+}
+
+bool planeValid(const FdPlane& plane, int32_t width, int32_t height)
+{
+    if (plane.fd < 0 || (plane.stride != 0 && plane.stride != static_cast<uint32_t>(width)))
+        return false;
+
+    // Catches stale or undersized fds before they reach the HW.
+    return importCache().size(plane.fd) >= static_cast<int64_t>(plane.offset) + static_cast<int64_t>(width) * height;
+}
+
+// The HW takes every plane from the start of its own fd.
+bool hwLayout(const FdBufferData& buffer, int format)
+{
+    return buffer.y.offset == 0 && (format != PIXEL_FORMAT_YUV_420_SP || buffer.uv.offset == 0);
+}
+
+int toBufferData(const FdBufferData& in, int format, BufferData& out)
+{
+    if (in.width <= 0 || in.height <= 0 || !planeValid(in.y, in.width, in.height))
+        return -EINVAL;
+
+    if (format == PIXEL_FORMAT_YUV_420_SP && !planeValid(in.uv, in.width, in.height / 2))
+        return -EINVAL;
+
+    out = BufferData();
+    out.fdY = in.y.fd;
+    out.fdUV = format == PIXEL_FORMAT_YUV_420_SP ? in.uv.fd : -1;
+    out.width = in.width;
+    out.height = in.height;
+    out.fov = in.fov;
+
+    return 0;
+}
+
+void syncPlane(int fd, uint64_t flags)
+{
+    struct dma_buf_sync sync = { flags };
+    if (ioctl(fd, DMA_BUF_IOCTL_SYNC, &sync))
+        ALOGW("failed to sync fd %d (%d)", fd, errno);
+}
+
+/**
+ * Maps the planes of one buffer for the SW path and brackets the CPU
+ * access with dma-buf syncs. Planes sharing an fd share a mapping.
+ */
+class CpuAccess {
+public:
+    CpuAccess(BufferData& buffer, const FdBufferData& planes, uint64_t access)
+        : mBuffer(buffer), mAccess(access), mSharedFd(buffer.fdUV == buffer.fdY)
+    {
+        mY = importCache().map(buffer.fdY);
+        if (buffer.fdUV >= 0)
+            mUV = mSharedFd ? mY : importCache().map(buffer.fdUV);
+
+        if (!mY || (buffer.fdUV >= 0 && !mUV))
+            return;
+
+        buffer.y = mY->addr + planes.y.offset;
+        buffer.uv = mUV ? mUV->addr + planes.uv.offset : NULL;
+
+        syncPlane(buffer.fdY, DMA_BUF_SYNC_START | mAccess);
+        if (mUV && !mSharedFd)
+            syncPlane(buffer.fdUV, DMA_BUF_SYNC_START | mAccess);
+    }
+
+    ~CpuAccess()
+    {
+        if (!mBuffer.y)
+            return;
+
+        syncPlane(mBuffer.fdY, DMA_BUF_SYNC_END | mAccess);
+        if (mUV && !mSharedFd)
+            syncPlane(mBuffer.fdUV, DMA_BUF_SYNC_END | mAccess);
+    }
+
+    explicit operator bool() const { return mBuffer.y != NULL; }
+
+private:
+    BufferData& mBuffer;
+    const uint64_t mAccess;
+    const bool mSharedFd;
+    std::shared_ptr<Mapping> mY;
+    std::shared_ptr<Mapping> mUV;
+};
+
+} // namespace
+
+int runCSCFd(FdBufferData& dst, FdBufferData& src, int format)
+{
+    BufferData dstData, srcData;
+    if (toBufferData(dst, format, dstData) || toBufferData(src, format, srcData))
+        return -EINVAL;
+
+    int ret = -EINVAL;
+    if (hwLayout(dst, format) && hwLayout(src, format)) {
+        ret = hwRunCSC(dstData, srcData, format);
+        if (ret == 0)
+            return 0;
+
+        ALOGW("runCSC() failed (%d), run SW scaler instead", ret);
+    }
+
+    CpuAccess srcAccess(srcData, src, DMA_BUF_SYNC_READ);
+    CpuAccess dstAccess(dstData, dst, DMA_BUF_SYNC_WRITE);
+    if (!srcAccess || !dstAccess)
+        return ret;
+
+    return runInterpBicubicFast(dstData, srcData, format);
+}
+
+int runGDCGridFd(FdBufferData& dst, FdBufferData& src, GDCGrid& grid, int format)
+{
+    BufferData dstData, srcData;
+    if (toBufferData(dst, format, dstData) || toBufferData(src, format, srcData))
+        return -EINVAL;
+
+    int ret = -EINVAL;
+    if (hwLayout(dst, format) && hwLayout(src, format)) {
+        ret = hwRunGDCGrid(dstData, srcData, grid, format, TARGET_GDC_HW);
+        if (ret == 0)
+            return 0;
+
+        ALOGW("runGDCGrid() failed (%d), run SW warper instead", ret);
+    }
+
+    CpuAccess srcAccess(srcData, src, DMA_BUF_SYNC_READ);
+    CpuAccess dstAccess(dstData, dst, DMA_BUF_SYNC_WRITE);
+    if (!srcAccess || !dstAccess)
+        return ret;
+
+    return runGDCGridTiled(dstData, srcData, grid, format);
+}
+
+void clearFdImports()
+{
+    importCache().clear();
+}
+
+} // namespace geoTransClient
+} // namespace hardware
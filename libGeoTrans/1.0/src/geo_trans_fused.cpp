@@ -0,0 +1,123 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+
+#include <log/log.h>
+
+#include "geo_trans_bicubic.h"
+#include "geo_trans_buffer_pool.h"
+#include "geo_trans_fused.h"
+#include "geo_trans_gdc.h"
+#include "GeoTransHw.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+BufferPool& intermediatePool()
+{
+    static BufferPool* pool = [] {
+        std::shared_ptr<BufferAllocator> allocator = createIonAllocator();
+        if (!allocator) {
+            ALOGW("no ion, warp intermediates come from the heap");
+            allocator = createHeapAllocator();
+        }
+        return new BufferPool(allocator);
+    }();
+
+    return *pool;
+}
+
+// Warped frame at source size, released back to the pool on scope exit.
+class Intermediate {
+public:
+    Intermediate(const BufferData& src, int format)
+    {
+        mStatus = intermediatePool().acquire(mBuffer, src.width, src.height, BUFFER_USAGE_GDC, format);
+    }
+
+    ~Intermediate()
+    {
+        if (mStatus == 0)
+            intermediatePool().release(mBuffer);
+    }
+
+    int status() const { return mStatus; }
+    BufferData& buffer() { return mBuffer; }
+
+    // Same buffer by fd only, so the HW path neither maps nor copies it.
+    BufferData deviceOnly() const
+    {
+        BufferData device = mBuffer;
+        device.y = NULL;
+        device.uv = NULL;
+        return device;
+    }
+
+private:
+    BufferData mBuffer;
+    int mStatus;
+};
+
+int runChainHW(BufferData& dst, BufferData& src, GDCGrid& grid, int format)
+{
+    Intermediate warped(src, format);
+    if (warped.status())
+        return warped.status();
+
+    BufferData device = warped.deviceOnly();
+    if (device.fdY < 0) {
+        // Heap intermediate, the HW path has to copy it anyway.
+        device = warped.buffer();
+    }
+
+    int ret = hwRunGDCGrid(device, src, grid, format, TARGET_GDC_HW);
+    if (ret)
+        return ret;
+
+    return hwRunCSC(dst, device, format);
+}
+
+int runChainSW(BufferData& dst, BufferData& src, GDCGrid& grid, int format)
+{
+    Intermediate warped(src, format);
+    if (warped.status())
+        return warped.status();
+
+    int ret = runGDCGridTiled(warped.buffer(), src, grid, format);
+    if (ret)
+        return ret;
+
+    return runInterpBicubicFast(dst, warped.buffer(), format);
+}
+
+} // namespace
+
+int runGDCGridScaled(BufferData& dst, BufferData& src, GDCGrid& grid, int format, int target)
+{
+    if (target != TARGET_GDC_HW && target != TARGET_GDC_C_MODEL)
+        return -EINVAL;
+
+    if (target == TARGET_GDC_C_MODEL) {
+        if (gdcScaleFoldable(dst, src))
+            return runGDCGridTiledScaled(dst, src, grid, format);
+        return runChainSW(dst, src, grid, format);
+    }
+
+    if (dst.width == src.width && dst.height == src.height)
+        return hwRunGDCGrid(dst, src, grid, format, TARGET_GDC_HW);
+
+    int ret = runChainHW(dst, src, grid, format);
+    if (ret == 0)
+        return 0;
+
+    if (!src.y || !dst.y || !gdcScaleFoldable(dst, src))
+        return ret;
+
+    ALOGW("warp and scale failed (%d), run SW warper instead", ret);
+    return runGDCGridTiledScaled(dst, src, grid, format);
+}
+
+} // namespace geoTransClient
+} // namespace hardware
@@ -0,0 +1,331 @@
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "geo_trans_gdc.h"
+#include "GeoTransWorkers.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+constexpr int GRID_SIZE = 33;
+constexpr int CELLS = GRID_SIZE - 1;
+constexpr int POS_BITS = 8;         // source positions in 1/256 pixel
+constexpr int FRAC_BITS = 6;        // bilinear weights in 1/64
+constexpr int WEIGHT_BITS = 16;     // node interpolation weights
+constexpr int MIN_WIDTH = 96;
+constexpr int MIN_HEIGHT = 64;
+constexpr int MAX_WIDTH = 8192;
+constexpr int MAX_HEIGHT = 6144;
+constexpr int ALIGN = 16;
+constexpr int TILE_WIDTH = 128;
+constexpr int TILE_HEIGHT = 32;
+constexpr int MAX_THREADS = 4;
+constexpr int MIN_SCALED = 4;
+
+// Grid scale of getGridSet(): the whole width spans 2 * 8192, the height 2 * 6144.
+constexpr int64_t SPAN_X = 16384;
+constexpr int64_t SPAN_Y = 12288;
+
+inline int32_t decode(int32_t value, int32_t size, int64_t span)
+{
+    // value = round((2 * d + 1) * span / 2 / size) << 8, back to d in 1/256 pixel.
+    int64_t scaled = static_cast<int64_t>(value) * size;
+    int64_t rounded = scaled >= 0 ? (scaled + span / 2) / span : -((-scaled + span / 2) / span);
+
+    return static_cast<int32_t>(rounded - (1 << (POS_BITS - 1)));
+}
+
+/**
+ * Per call state: node displacements in 1/256 luma pixel and the node
+ * spacing, shared by every tile of both planes.
+ */
+struct Warp {
+    int32_t nodeX[GRID_SIZE][GRID_SIZE];
+    int32_t nodeY[GRID_SIZE][GRID_SIZE];
+    int stepX;
+    int stepY;
+
+    Warp(const GDCGrid& grid, int width, int height)
+        : stepX(std::max(1, (width + CELLS / 2) / CELLS)),
+          stepY(std::max(1, (height + CELLS / 2) / CELLS))
+    {
+        for (int row = 0; row < GRID_SIZE; row++) {
+            for (int col = 0; col < GRID_SIZE; col++) {
+                nodeX[row][col] = decode(grid.gridX[row][col], width, SPAN_X);
+                nodeY[row][col] = decode(grid.gridY[row][col], height, SPAN_Y);
+            }
+        }
+    }
+};
+
+/**
+ * Unwarped position, cell and weight of every output column or row.
+ * An output scaled against the source samples the warp at
+ * i * srcSize / dstSize, which folds the scale into the grid.
+ */
+struct Axis {
+    std::vector<int32_t> base;      // in 1/256 plane pixel
+    std::vector<int32_t> cell;
+    std::vector<int32_t> weight;
+
+    Axis(int dstSize, int srcSize, int sub, int step) : base(dstSize), cell(dstSize), weight(dstSize) {
+        for (int i = 0; i < dstSize; i++) {
+            int64_t pos = (static_cast<int64_t>(i) << POS_BITS) * srcSize / dstSize;
+            int64_t luma = pos * sub;
+            int c = std::min(static_cast<int>((luma >> POS_BITS) / step), CELLS - 1);
+
+            base[i] = static_cast<int32_t>(pos);
+            cell[i] = c;
+            // Past the last node the outer cell is extrapolated.
+            weight[i] = static_cast<int32_t>(((luma - (static_cast<int64_t>(c * step) << POS_BITS))
+                                              << (WEIGHT_BITS - POS_BITS)) / step);
+        }
+    }
+};
+
+// One plane of samples made of channels interleaved bytes.
+struct Plane {
+    const uint8_t* src;
+    uint8_t* dst;
+    int width;          // source size
+    int height;
+    int dstWidth;
+    int dstHeight;
+    int channels;
+    int sub;            // 2 for chroma, displacements are halved
+};
+
+inline int32_t lerp(int32_t a, int32_t b, int32_t weight)
+{
+    return a + static_cast<int32_t>((static_cast<int64_t>(b - a) * weight) >> WEIGHT_BITS);
+}
+
+// out = ((p00 * (64 - fx) + p01 * fx) * (64 - fy) + (p10 * (64 - fx) + p11 * fx) * fy + 2048) >> 12
+void blend(const int16_t* p00, const int16_t* p01, const int16_t* p10, const int16_t* p11,
+           const int16_t* fx, const int16_t* fy, uint8_t* dst, int count)
+{
+    constexpr int ONE = 1 << FRAC_BITS;
+    constexpr int SHIFT = FRAC_BITS * 2;
+    int i = 0;
+
+#if defined(__ARM_NEON)
+    const int16x8_t one = vdupq_n_s16(ONE);
+
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t wx = vld1q_s16(fx + i), wy = vld1q_s16(fy + i);
+        int16x8_t ix = vsubq_s16(one, wx), iy = vsubq_s16(one, wy);
+
+        int16x8_t top = vmlaq_s16(vmulq_s16(vld1q_s16(p00 + i), ix), vld1q_s16(p01 + i), wx);
+        int16x8_t bottom = vmlaq_s16(vmulq_s16(vld1q_s16(p10 + i), ix), vld1q_s16(p11 + i), wx);
+
+        int32x4_t lo = vmlal_s16(vmull_s16(vget_low_s16(top), vget_low_s16(iy)), vget_low_s16(bottom), vget_low_s16(wy));
+        int32x4_t hi = vmlal_s16(vmull_s16(vget_high_s16(top), vget_high_s16(iy)), vget_high_s16(bottom), vget_high_s16(wy));
+
+        int16x8_t sum = vcombine_s16(vrshrn_n_s32(lo, SHIFT), vrshrn_n_s32(hi, SHIFT));
+        vst1_u8(dst + i, vqmovun_s16(sum));
+    }
+#elif defined(__SSE2__)
+    const __m128i one = _mm_set1_epi16(ONE);
+    const __m128i round = _mm_set1_epi32(1 << (SHIFT - 1));
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i wx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fx + i));
+        __m128i wy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fy + i));
+        __m128i ix = _mm_sub_epi16(one, wx), iy = _mm_sub_epi16(one, wy);
+
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p00 + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p01 + i));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p10 + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p11 + i));
+
+        // Products stay below 255 * 64, so 16 bit lanes are enough horizontally.
+        __m128i top = _mm_add_epi16(_mm_mullo_epi16(a, ix), _mm_mullo_epi16(b, wx));
+        __m128i bottom = _mm_add_epi16(_mm_mullo_epi16(c, ix), _mm_mullo_epi16(d, wx));
+
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(top, bottom), _mm_unpacklo_epi16(iy, wy));
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(top, bottom), _mm_unpackhi_epi16(iy, wy));
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, round), SHIFT);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, round), SHIFT);
+
+        __m128i sum = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(sum, sum));
+    }
+#endif
+
+    for (; i < count; i++) {
+        int top = p00[i] * (ONE - fx[i]) + p01[i] * fx[i];
+        int bottom = p10[i] * (ONE - fx[i]) + p11[i] * fx[i];
+        dst[i] = static_cast<uint8_t>((top * (ONE - fy[i]) + bottom * fy[i] + (1 << (SHIFT - 1))) >> SHIFT);
+    }
+}
+
+class TileWarper {
+public:
+    TileWarper(const Warp& warp, const Plane& plane)
+        : mWarp(warp), mPlane(plane),
+          mColumns(plane.dstWidth, plane.width, plane.sub, warp.stepX),
+          mRows(plane.dstHeight, plane.height, plane.sub, warp.stepY),
+          mTilesX((plane.dstWidth + TILE_WIDTH - 1) / TILE_WIDTH),
+          mTilesY((plane.dstHeight + TILE_HEIGHT - 1) / TILE_HEIGHT),
+          mShift(plane.sub / 2)
+    {
+    }
+
+    int tiles() const { return mTilesX * mTilesY; }
+
+    void run(int tile)
+    {
+        const int x0 = (tile % mTilesX) * TILE_WIDTH;
+        const int y0 = (tile / mTilesX) * TILE_HEIGHT;
+        const int width = std::min(TILE_WIDTH, mPlane.dstWidth - x0);
+        const int height = std::min(TILE_HEIGHT, mPlane.dstHeight - y0);
+        const int count = width * mPlane.channels;
+
+        const int maxX = (mPlane.width - 1) << POS_BITS;
+        const int maxY = (mPlane.height - 1) << POS_BITS;
+
+        int16_t p[4][TILE_WIDTH * 2];
+        int16_t fx[TILE_WIDTH * 2];
+        int16_t fy[TILE_WIDTH * 2];
+        int32_t rowX[GRID_SIZE];
+        int32_t rowY[GRID_SIZE];
+
+        for (int y = y0; y < y0 + height; y++) {
+            const int cellY = mRows.cell[y];
+            const int weightY = mRows.weight[y];
+
+            // Node displacements along this row, reused by every column of the tile.
+            for (int col = 0; col < GRID_SIZE; col++) {
+                rowX[col] = lerp(mWarp.nodeX[cellY][col], mWarp.nodeX[cellY + 1][col], weightY);
+                rowY[col] = lerp(mWarp.nodeY[cellY][col], mWarp.nodeY[cellY + 1][col], weightY);
+            }
+
+            for (int x = x0; x < x0 + width; x++) {
+                const int cellX = mColumns.cell[x];
+                const int weightX = mColumns.weight[x];
+
+                int32_t posX = mColumns.base[x] + (lerp(rowX[cellX], rowX[cellX + 1], weightX) >> mShift);
+                int32_t posY = mRows.base[y] + (lerp(rowY[cellX], rowY[cellX + 1], weightX) >> mShift);
+                posX = std::min(std::max(posX, 0), maxX);
+                posY = std::min(std::max(posY, 0), maxY);
+
+                const int sx = posX >> POS_BITS;
+                const int sy = posY >> POS_BITS;
+                const int nx = std::min(sx + 1, mPlane.width - 1);
+                const int ny = std::min(sy + 1, mPlane.height - 1);
+
+                const uint8_t* top = mPlane.src + static_cast<size_t>(sy) * mPlane.width * mPlane.channels;
+                const uint8_t* bottom = mPlane.src + static_cast<size_t>(ny) * mPlane.width * mPlane.channels;
+
+                for (int c = 0; c < mPlane.channels; c++) {
+                    const int i = (x - x0) * mPlane.channels + c;
+                    p[0][i] = top[sx * mPlane.channels + c];
+                    p[1][i] = top[nx * mPlane.channels + c];
+                    p[2][i] = bottom[sx * mPlane.channels + c];
+                    p[3][i] = bottom[nx * mPlane.channels + c];
+                    fx[i] = static_cast<int16_t>((posX >> (POS_BITS - FRAC_BITS)) & ((1 << FRAC_BITS) - 1));
+                    fy[i] = static_cast<int16_t>((posY >> (POS_BITS - FRAC_BITS)) & ((1 << FRAC_BITS) - 1));
+                }
+            }
+
+            uint8_t* dst = mPlane.dst + (static_cast<size_t>(y) * mPlane.dstWidth + x0) * mPlane.channels;
+            blend(p[0], p[1], p[2], p[3], fx, fy, dst, count);
+        }
+    }
+
+private:
+    const Warp& mWarp;
+    const Plane mPlane;
+    const Axis mColumns;
+    const Axis mRows;
+    const int mTilesX;
+    const int mTilesY;
+    const int mShift;
+};
+
+bool validSource(const BufferData& dst, const BufferData& src, int format)
+{
+    if (format != PIXEL_FORMAT_Y_GRAY && format != PIXEL_FORMAT_YUV_420_SP)
+        return false;
+
+    if (!src.y || !dst.y || (format == PIXEL_FORMAT_YUV_420_SP && (!src.uv || !dst.uv)))
+        return false;
+
+    return src.width >= MIN_WIDTH && src.height >= MIN_HEIGHT && src.width <= MAX_WIDTH && src.height <= MAX_HEIGHT &&
+           !(src.width % ALIGN) && !(src.height % ALIGN);
+}
+
+void warpTiled(BufferData& dst, BufferData& src, const GDCGrid& grid, int format)
+{
+    const Warp warp(grid, src.width, src.height);
+
+    std::vector<TileWarper> planes;
+    planes.reserve(2);
+    planes.emplace_back(warp, Plane{ src.y, dst.y, src.width, src.height, dst.width, dst.height, 1, 1 });
+    if (format == PIXEL_FORMAT_YUV_420_SP)
+        planes.emplace_back(warp, Plane{ src.uv, dst.uv, src.width / 2, src.height / 2,
+                                         dst.width / 2, dst.height / 2, 2, 2 });
+
+    int total = 0;
+    for (auto& plane : planes)
+        total += plane.tiles();
+
+    // Tiles are handed out in raster order, so concurrent tiles read neighbouring source windows.
+    GeoTransWorkers::shared().run(total, MAX_THREADS, [&planes](int tile) {
+        for (auto& plane : planes) {
+            if (tile < plane.tiles()) {
+                plane.run(tile);
+                return;
+            }
+            tile -= plane.tiles();
+        }
+    });
+}
+
+} // namespace
+
+int runGDCGridTiled(BufferData& dst, BufferData& src, const GDCGrid& grid, int format)
+{
+    if (!validSource(dst, src, format) || src.width != dst.width || src.height != dst.height)
+        return -EINVAL;
+
+    warpTiled(dst, src, grid, format);
+    return 0;
+}
+
+int runGDCGridTiledScaled(BufferData& dst, BufferData& src, const GDCGrid& grid, int format)
+{
+    if (!validSource(dst, src, format))
+        return -EINVAL;
+
+    if (dst.width < MIN_SCALED || dst.height < MIN_SCALED || dst.width > MAX_WIDTH || dst.height > MAX_WIDTH ||
+        (format == PIXEL_FORMAT_YUV_420_SP && ((dst.width | dst.height) & 1)))
+        return -EINVAL;
+
+    if (!gdcScaleFoldable(dst, src))
+        return -EINVAL;
+
+    warpTiled(dst, src, grid, format);
+    return 0;
+}
+
+bool gdcScaleFoldable(const BufferData& dst, const BufferData& src)
+{
+    // Bilinear taps alias below half size, and look soft above twice.
+    return dst.width * 2 >= src.width && dst.width <= src.width * 2 &&
+           dst.height * 2 >= src.height && dst.height <= src.height * 2;
+}
+
+} // namespace geoTransClient
+} // namespace hardware
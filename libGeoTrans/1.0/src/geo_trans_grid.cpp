@@ -0,0 +1,163 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <list>
+#include <mutex>
+
+#include <cutils/properties.h>
+#include <log/log.h>
+
+#include "geo_trans_gdc.h"
+#include "geo_trans_grid.h"
+#include "GeoTransHw.h"
+
+/**
+ * Affine to grid conversion exported by libGeoTrans10, as called by
+ * runGDCMatrix(): one (x, y) pair per grid node, clamped to the image
+ * when the last argument is set.
+ */
+struct _pos {
+    double x;
+    double y;
+};
+
+void getGridSet(int width, int height, double* matrix, _pos* grid,
+                int* shiftX, int* shiftY, int* scaleX, int* scaleY, int* stepX, int* stepY, int clamp);
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+constexpr int GRID_SIZE = 33;
+
+GDCGridCache& gridCache()
+{
+    static GDCGridCache* cache = new GDCGridCache(GDCGridCache::defaultCapacity(), GDCGridCache::defaultQuantBits());
+    return *cache;
+}
+
+} // namespace
+
+GDCGridCache::GDCGridCache(size_t capacity, int quantBits)
+    : mCapacity(capacity), mQuantBits(std::min(12, std::max(0, quantBits)))
+{
+}
+
+GDCGridHandle GDCGridCache::get(const BufferData& src, const short* affine)
+{
+    if (!affine)
+        return nullptr;
+
+    Key key;
+    key.width = src.width;
+    key.height = src.height;
+    for (size_t i = 0; i < MATRIX_TERMS; i++)
+        key.matrix[i] = quantize(affine[i]);
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+            if (it->first == key) {
+                mEntries.splice(mEntries.begin(), mEntries, it);
+                return it->second;
+            }
+        }
+    }
+
+    // Built outside the lock, two threads may build the same grid once each.
+    GDCGridHandle grid = compileGDCMatrix(src, key.matrix.data());
+    if (!grid || mCapacity == 0)
+        return grid;
+
+    std::lock_guard<std::mutex> lock(mLock);
+    mEntries.emplace_front(key, grid);
+    if (mEntries.size() > mCapacity)
+        mEntries.pop_back();
+
+    return grid;
+}
+
+short GDCGridCache::quantize(short value) const
+{
+    if (mQuantBits == 0)
+        return value;
+
+    int step = 1 << mQuantBits;
+    int rounded = ((value + step / 2) >> mQuantBits) << mQuantBits;
+
+    return static_cast<short>(std::min(32767, rounded));
+}
+
+size_t GDCGridCache::defaultCapacity()
+{
+    return std::max(0, property_get_int32("ro.vendor.geotrans.grid_cache_size", 8));
+}
+
+int GDCGridCache::defaultQuantBits()
+{
+    return property_get_int32("ro.vendor.geotrans.grid_quant_bits", 0);
+}
+
+GDCGridHandle compileGDCMatrix(const BufferData& src, const short* affine)
+{
+    if (!affine || src.width <= 0 || src.height <= 0)
+        return nullptr;
+
+    // Same scaling as runGDCMatrix(): Q12 linear terms, Q5 translations.
+    double matrix[9] = {
+        affine[0] / 4096.0, affine[1] / 4096.0, affine[2] / 32.0,
+        affine[3] / 4096.0, affine[4] / 4096.0, affine[5] / 32.0,
+        0.0, 0.0, 1.0,
+    };
+
+    std::unique_ptr<_pos[]> nodes(new _pos[GRID_SIZE * GRID_SIZE]());
+    int shiftX, shiftY, scaleX, scaleY, stepX, stepY;
+
+    getGridSet(src.width, src.height, matrix, nodes.get(), &shiftX, &shiftY, &scaleX, &scaleY, &stepX, &stepY, 1);
+
+    std::shared_ptr<GDCGrid> grid = std::make_shared<GDCGrid>();
+    for (int row = 0; row < GRID_SIZE; row++) {
+        for (int col = 0; col < GRID_SIZE; col++) {
+            const _pos& node = nodes[row * GRID_SIZE + col];
+            grid->gridX[row][col] = static_cast<int32_t>(node.x);
+            grid->gridY[row][col] = static_cast<int32_t>(node.y);
+        }
+    }
+
+    return grid;
+}
+
+int runGDCGridHandle(BufferData& dst, BufferData& src, const GDCGridHandle& grid, int format, int target)
+{
+    if (!grid)
+        return -EINVAL;
+
+    // The prebuilt C model shares the GDC globals, the tiled one is reentrant.
+    if (target == TARGET_GDC_C_MODEL)
+        return runGDCGridTiled(dst, src, *grid, format);
+
+    // runGDCGrid() takes a mutable grid, the handle stays untouched.
+    GDCGrid copy;
+    memcpy(&copy, grid.get(), sizeof(copy));
+
+    return hwRunGDCGrid(dst, src, copy, format, target);
+}
+
+int runGDCMatrixCached(BufferData& dst, BufferData& src, const short* affine, int format, int target)
+{
+    GDCGridHandle grid = gridCache().get(src, affine);
+    if (!grid) {
+        ALOGE("failed to build grid for %dx%d", src.width, src.height);
+        return -EINVAL;
+    }
+
+    return runGDCGridHandle(dst, src, grid, format, target);
+}
+
+} // namespace geoTransClient
+} // namespace hardware
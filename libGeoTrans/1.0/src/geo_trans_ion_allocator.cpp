@@ -0,0 +1,79 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <ion/ion.h>
+#include <log/log.h>
+
+#include "geo_trans_buffer_pool.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+namespace {
+
+// Same heap, flags and alignment as the buffers runCSC() and runGDCGrid() allocate.
+constexpr unsigned int ION_HEAP_MASK = ION_HEAP_SYSTEM_MASK;
+constexpr unsigned int ION_FLAGS = ION_FLAG_CACHED | ION_FLAG_CACHED_NEEDS_SYNC;
+constexpr size_t ION_ALIGN = 4096;
+
+class IonAllocator : public BufferAllocator {
+public:
+    explicit IonAllocator(int client) : mClient(client) {}
+
+    ~IonAllocator() override
+    {
+        ion_close(mClient);
+    }
+
+    int allocate(size_t size, int* fd, unsigned char** addr) override
+    {
+        int shared = -1;
+        int ret = ion_alloc_fd(mClient, size, ION_ALIGN, ION_HEAP_MASK, ION_FLAGS, &shared);
+        if (ret < 0) {
+            ALOGE("failed to allocate %zu bytes (%d)", size, ret);
+            return ret;
+        }
+
+        void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shared, 0);
+        if (mapped == MAP_FAILED) {
+            int err = errno;
+            ALOGE("failed to map %zu bytes (%d)", size, err);
+            close(shared);
+            return -err;
+        }
+
+        *fd = shared;
+        *addr = static_cast<unsigned char*>(mapped);
+        return 0;
+    }
+
+    void free(size_t size, int fd, unsigned char* addr) override
+    {
+        if (addr)
+            munmap(addr, size);
+        if (fd >= 0)
+            close(fd);
+    }
+
+private:
+    const int mClient;
+};
+
+} // namespace
+
+std::shared_ptr<BufferAllocator> createIonAllocator()
+{
+    int client = ion_open();
+    if (client < 0) {
+        ALOGE("failed to open ion (%d)", client);
+        return nullptr;
+    }
+
+    return std::make_shared<IonAllocator>(client);
+}
+
+} // namespace geoTransClient
+} // namespace hardware
@@ -0,0 +1,132 @@
+#define LOG_TAG "GeoTrans"
+
+#include <errno.h>
+#include <string.h>
+
+#include <array>
+
+#include <log/log.h>
+
+#include "geo_trans_bicubic.h"
+#include "geo_trans_gdc.h"
+#include "geo_trans_session.h"
+#include "GeoTransEngine.h"
+#include "GeoTransHw.h"
+
+namespace hardware {
+namespace geoTransClient {
+
+int initShared()
+{
+    return hwAcquireClient();
+}
+
+int deinitShared()
+{
+    return hwReleaseClient();
+}
+
+std::shared_ptr<GeoTransSession> GeoTransSession::create()
+{
+    if (hwAcquireClient())
+        return nullptr;
+
+    return std::shared_ptr<GeoTransSession>(new GeoTransSession());
+}
+
+GeoTransSession::GeoTransSession()
+    : mGrids(GDCGridCache::defaultCapacity(), GDCGridCache::defaultQuantBits())
+{
+    static const char* names[ENGINE_COUNT] = { "csc", "gdc", "bicubic" };
+
+    for (int i = 0; i < ENGINE_COUNT; i++)
+        mEngines[i].reset(new GeoTransEngine(names[i], GeoTransEngine::defaultDepth()));
+
+    std::shared_ptr<BufferAllocator> allocator = createIonAllocator();
+    if (!allocator) {
+        ALOGW("no ion, session buffers come from the heap");
+        allocator = createHeapAllocator();
+    }
+    mBuffers.reset(new BufferPool(allocator));
+}
+
+GeoTransSession::~GeoTransSession()
+{
+    // Engines drain their queues when destroyed, before the pool and the client go.
+    for (auto& engine : mEngines)
+        engine.reset();
+    mBuffers.reset();
+
+    hwReleaseClient();
+}
+
+std::future<int> GeoTransSession::submit(int id, std::function<int()> run, Callback callback)
+{
+    auto promise = std::make_shared<std::promise<int>>();
+    std::future<int> future = promise->get_future();
+
+    mEngines[id]->post([run, callback, promise]() {
+        int status = run();
+        if (callback)
+            callback(status);
+        promise->set_value(status);
+    });
+
+    return future;
+}
+
+std::future<int> GeoTransSession::runCSC(const BufferData& dst, const BufferData& src, int format, Callback callback)
+{
+    return submit(ENGINE_CSC, [dst = dst, src = src, format]() mutable {
+        return hwRunCSC(dst, src, format);
+    }, callback);
+}
+
+std::future<int> GeoTransSession::runGDCGrid(const BufferData& dst, const BufferData& src, const GDCGrid& grid,
+                                             int format, int target, Callback callback)
+{
+    auto copy = std::make_shared<GDCGrid>(grid);
+
+    return submit(ENGINE_GDC, [dst = dst, src = src, copy, format, target]() mutable {
+        // The prebuilt C model shares the GDC globals, the tiled one keeps sessions apart.
+        if (target == TARGET_GDC_C_MODEL)
+            return runGDCGridTiled(dst, src, *copy, format);
+        return hwRunGDCGrid(dst, src, *copy, format, target);
+    }, callback);
+}
+
+std::future<int> GeoTransSession::runGDCMatrix(const BufferData& dst, const BufferData& src, const short* affine,
+                                               int format, int target, Callback callback)
+{
+    std::array<short, 6> matrix;
+    memcpy(matrix.data(), affine, sizeof(short) * matrix.size());
+
+    return submit(ENGINE_GDC, [this, dst = dst, src = src, matrix, format, target]() mutable {
+        GDCGridHandle grid = mGrids.get(src, matrix.data());
+        if (!grid)
+            return -EINVAL;
+
+        if (target == TARGET_GDC_C_MODEL)
+            return runGDCGridTiled(dst, src, *grid, format);
+
+        GDCGrid copy = *grid;
+        return hwRunGDCGrid(dst, src, copy, format, target);
+    }, callback);
+}
+
+std::future<int> GeoTransSession::runInterpBicubic(const BufferData& dst, const BufferData& src, int format,
+                                                   Callback callback)
+{
+    return submit(ENGINE_BICUBIC, [dst = dst, src = src, format]() mutable {
+        return runInterpBicubicFast(dst, src, format);
+    }, callback);
+}
+
+void GeoTransSession::waitIdle()
+{
+    for (auto& engine : mEngines)
+        engine->waitIdle();
+}
+
+} // namespace geoTransClient
+} // namespace hardware
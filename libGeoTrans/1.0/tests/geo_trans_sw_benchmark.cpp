@@ -0,0 +1,109 @@
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "geo_trans_bicubic.h"
+#include "geo_trans_gdc.h"
+
+using namespace hardware::geoTransClient;
+
+namespace {
+
+// 8b YCbCr 420 semi-planar image with non flat content.
+struct Image {
+    Image(int width, int height) : luma(width * height), chroma(width * height / 2)
+    {
+        buffer.y = luma.data();
+        buffer.uv = chroma.data();
+        buffer.width = width;
+        buffer.height = height;
+
+        for (int i = 0; i < width * height; i++)
+            luma[i] = static_cast<uint8_t>(i * 7 + i / width * 3);
+        for (int i = 0; i < width * height / 2; i++)
+            chroma[i] = static_cast<uint8_t>(128 + i % 61);
+    }
+
+    // buffer points into the planes.
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+
+    std::vector<uint8_t> luma;
+    std::vector<uint8_t> chroma;
+    BufferData buffer;
+};
+
+// Rotation by angle around the image centre, encoded as getGridSet() does, see geo_trans_gdc.h.
+GDCGrid rotationGrid(int width, int height, double angle)
+{
+    GDCGrid grid;
+    const int stepX = (width + 16) / 32, stepY = (height + 16) / 32;
+
+    for (int row = 0; row < 33; row++) {
+        for (int col = 0; col < 33; col++) {
+            double x = col * stepX - width / 2.0, y = row * stepY - height / 2.0;
+            double dx = lround(cos(angle) * x - sin(angle) * y - x);
+            double dy = lround(sin(angle) * x + cos(angle) * y - y);
+            grid.gridX[row][col] = static_cast<int32_t>(lround((2 * dx + 1) * 8192 / width)) << 8;
+            grid.gridY[row][col] = static_cast<int32_t>(lround((2 * dy + 1) * 6144 / height)) << 8;
+        }
+    }
+
+    return grid;
+}
+
+void setThroughput(benchmark::State& state, const Image& dst)
+{
+    int64_t pixels = static_cast<int64_t>(dst.buffer.width) * dst.buffer.height;
+    state.SetItemsProcessed(state.iterations() * pixels);
+    state.SetBytesProcessed(state.iterations() * pixels * 3 / 2);
+}
+
+}  // namespace
+
+// Output pixels per second, from 1080p up to the 8192x8192 limit.
+static void BM_InterpBicubicFast(benchmark::State& state)
+{
+    Image src(state.range(0), state.range(1)), dst(state.range(2), state.range(3));
+
+    for (auto _ : state) {
+        if (runInterpBicubicFast(dst.buffer, src.buffer) != 0)
+            state.SkipWithError("scale failed");
+    }
+
+    setThroughput(state, dst);
+}
+BENCHMARK(BM_InterpBicubicFast)
+    ->Args({ 1920, 1080, 1280, 720 })
+    ->Args({ 1920, 1080, 3840, 2160 })
+    ->Args({ 3840, 2160, 1920, 1080 })
+    ->Args({ 4096, 4096, 8192, 8192 })
+    ->Args({ 8192, 8192, 4096, 4096 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Output pixels per second of the tiled warper, up to the 8192x6144 limit.
+static void BM_GDCGridTiled(benchmark::State& state)
+{
+    const int width = state.range(0), height = state.range(1);
+    Image src(width, height), dst(width, height);
+    GDCGrid grid = rotationGrid(width, height, 0.02);
+
+    for (auto _ : state) {
+        if (runGDCGridTiled(dst.buffer, src.buffer, grid) != 0)
+            state.SkipWithError("warp failed");
+    }
+
+    setThroughput(state, dst);
+}
+BENCHMARK(BM_GDCGridTiled)
+    ->Args({ 1920, 1088 })
+    ->Args({ 3840, 2160 })
+    ->Args({ 8192, 6144 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,442 @@
+#include <math.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "geo_trans_bicubic.h"
+#include "geo_trans_buffer_pool.h"
+#include "geo_trans_gdc.h"
+
+using namespace hardware::geoTransClient;
+
+namespace {
+
+// 8b YCbCr 420 semi-planar image with smooth content, so that fixed point
+// position errors stay small against the double references.
+struct Image {
+    Image(int width, int height) : luma(width * height), chroma(width * height / 2)
+    {
+        buffer.y = luma.data();
+        buffer.uv = chroma.data();
+        buffer.width = width;
+        buffer.height = height;
+    }
+
+    // buffer points into the planes.
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+
+    void fill()
+    {
+        const int width = buffer.width, height = buffer.height;
+
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                luma[y * width + x] = static_cast<uint8_t>(128 + 100 * sin(x * 0.05) * cos(y * 0.07));
+
+        for (int y = 0; y < height / 2; y++)
+            for (int x = 0; x < width; x++)
+                chroma[y * width + x] = static_cast<uint8_t>(128 + 60 * sin(x * 0.04 + y * 0.03));
+    }
+
+    uint8_t at(int plane, int x, int y, int c) const
+    {
+        if (plane == 0)
+            return luma[y * buffer.width + x];
+        return chroma[y * buffer.width + x * 2 + c];
+    }
+
+    std::vector<uint8_t> luma;
+    std::vector<uint8_t> chroma;
+    BufferData buffer;
+};
+
+// Largest difference of every sample against reference(plane, x, y, c),
+// on planes of the destination size. Fixed point paths stay within 1.
+// The largest sizes are checked on every step-th row and column only.
+template <typename Reference>
+double maxError(const Image& dst, int format, Reference reference, int step = 1)
+{
+    double error = 0;
+
+    for (int plane = 0; plane < (format == PIXEL_FORMAT_YUV_420_SP ? 2 : 1); plane++) {
+        int width = dst.buffer.width >> plane, height = dst.buffer.height >> plane;
+        for (int y = 0; y < height; y += step)
+            for (int x = 0; x < width; x += step)
+                for (int c = 0; c < (plane ? 2 : 1); c++)
+                    error = std::max(error, fabs(reference(plane, x, y, c) - dst.at(plane, x, y, c)));
+    }
+
+    return error;
+}
+
+void catmullRom(double t, double w[4])
+{
+    w[0] = ((-0.5 * t + 1.0) * t - 0.5) * t;
+    w[1] = (1.5 * t - 2.5) * t * t + 1.0;
+    w[2] = ((-1.5 * t + 2.0) * t + 0.5) * t;
+    w[3] = (0.5 * t - 0.5) * t * t;
+}
+
+// runInterpBicubic() positions, dst * ((src << 6) / dst) in 1/64, in double.
+double bicubicReference(const Image& src, int dstWidth, int dstHeight, int plane, int x, int y, int c)
+{
+    const int width = src.buffer.width >> plane, height = src.buffer.height >> plane;
+    const int64_t stepX = (static_cast<int64_t>(width) << 6) / (dstWidth >> plane);
+    const int64_t stepY = (static_cast<int64_t>(height) << 6) / (dstHeight >> plane);
+    const int64_t px = x * stepX, py = y * stepY;
+
+    double wx[4], wy[4];
+    catmullRom((px & 63) / 64.0, wx);
+    catmullRom((py & 63) / 64.0, wy);
+
+    double sum = 0;
+    for (int j = 0; j < 4; j++) {
+        for (int i = 0; i < 4; i++) {
+            int sx = std::min(std::max(static_cast<int>(px >> 6) - 1 + i, 0), width - 1);
+            int sy = std::min(std::max(static_cast<int>(py >> 6) - 1 + j, 0), height - 1);
+            sum += wx[i] * wy[j] * src.at(plane, sx, sy, c);
+        }
+    }
+
+    return std::min(255.0, std::max(0.0, sum));
+}
+
+// Displacement of every node, in luma pixels.
+struct Displacement {
+    double dx[33][33];
+    double dy[33][33];
+};
+
+// Encodes node displacements as getGridSet() does, see geo_trans_gdc.h.
+GDCGrid encodeGrid(const Displacement& d, int width, int height)
+{
+    GDCGrid grid;
+
+    for (int row = 0; row < 33; row++) {
+        for (int col = 0; col < 33; col++) {
+            grid.gridX[row][col] = static_cast<int32_t>(lround((2 * d.dx[row][col] + 1) * 8192 / width)) << 8;
+            grid.gridY[row][col] = static_cast<int32_t>(lround((2 * d.dy[row][col] + 1) * 6144 / height)) << 8;
+        }
+    }
+
+    return grid;
+}
+
+// Rotation by angle around the image centre, rounded to whole pixels at the nodes.
+Displacement rotation(int width, int height, double angle)
+{
+    Displacement d;
+    const int stepX = (width + 16) / 32, stepY = (height + 16) / 32;
+
+    for (int row = 0; row < 33; row++) {
+        for (int col = 0; col < 33; col++) {
+            double x = col * stepX - width / 2.0, y = row * stepY - height / 2.0;
+            d.dx[row][col] = lround(cos(angle) * x - sin(angle) * y - x);
+            d.dy[row][col] = lround(sin(angle) * x + cos(angle) * y - y);
+        }
+    }
+
+    return d;
+}
+
+// The warp of geo_trans_gdc.h in double: node displacements decoded from
+// the grid, interpolated bilinearly, then a bilinear source sample.
+double warpReference(const Image& src, const GDCGrid& grid, int dstWidth, int dstHeight,
+                     int plane, int x, int y, int c)
+{
+    const int width = src.buffer.width, height = src.buffer.height;
+    const int sub = 1 << plane;
+    const int stepX = std::max(1, (width + 16) / 32), stepY = std::max(1, (height + 16) / 32);
+
+    // Output positions on the source plane, and the same in luma pixels for the grid.
+    double u = static_cast<double>(x) * (width / sub) / (dstWidth / sub);
+    double v = static_cast<double>(y) * (height / sub) / (dstHeight / sub);
+    double lu = u * sub, lv = v * sub;
+
+    int cx = std::min(static_cast<int>(lu / stepX), 31), cy = std::min(static_cast<int>(lv / stepY), 31);
+    double fx = (lu - cx * stepX) / stepX, fy = (lv - cy * stepY) / stepY;
+
+    auto node = [&](int row, int col, bool vertical) {
+        return vertical ? grid.gridY[row][col] * static_cast<double>(height) / 12288 / 256 - 0.5
+                        : grid.gridX[row][col] * static_cast<double>(width) / 16384 / 256 - 0.5;
+    };
+    auto displacement = [&](bool vertical) {
+        double top = node(cy, cx, vertical) * (1 - fx) + node(cy, cx + 1, vertical) * fx;
+        double bottom = node(cy + 1, cx, vertical) * (1 - fx) + node(cy + 1, cx + 1, vertical) * fx;
+        return (top * (1 - fy) + bottom * fy) / sub;
+    };
+
+    const int planeWidth = width / sub, planeHeight = height / sub;
+    double px = std::min(std::max(u + displacement(false), 0.0), planeWidth - 1.0);
+    double py = std::min(std::max(v + displacement(true), 0.0), planeHeight - 1.0);
+
+    int sx = static_cast<int>(px), sy = static_cast<int>(py);
+    int nx = std::min(sx + 1, planeWidth - 1), ny = std::min(sy + 1, planeHeight - 1);
+    double wx = px - sx, wy = py - sy;
+
+    double top = src.at(plane, sx, sy, c) * (1 - wx) + src.at(plane, nx, sy, c) * wx;
+    double bottom = src.at(plane, sx, ny, c) * (1 - wx) + src.at(plane, nx, ny, c) * wx;
+    return top * (1 - wy) + bottom * wy;
+}
+
+// Heap allocator that counts the blocks it has out.
+class CountingAllocator : public BufferAllocator {
+public:
+    int allocate(size_t size, int* fd, unsigned char** addr) override
+    {
+        int ret = mHeap->allocate(size, fd, addr);
+        if (!ret)
+            blocks++;
+        return ret;
+    }
+
+    void free(size_t size, int fd, unsigned char* addr) override
+    {
+        mHeap->free(size, fd, addr);
+        blocks--;
+    }
+
+    int blocks = 0;
+
+private:
+    std::shared_ptr<BufferAllocator> mHeap = createHeapAllocator();
+};
+
+} // namespace
+
+TEST(GeoTransBufferPoolTest, ReusesReleasedBuffers)
+{
+    auto allocator = std::make_shared<CountingAllocator>();
+    BufferPool pool(allocator);
+
+    BufferData first;
+    ASSERT_EQ(pool.acquire(first, 1920, 1080, BUFFER_USAGE_GDC), 0);
+    EXPECT_EQ(first.width, 1920);
+    EXPECT_EQ(first.height, 1088);
+    EXPECT_EQ(first.fov.b, 1080);
+    unsigned char* luma = first.y;
+    pool.release(first);
+
+    // Same size class, served from the released planes.
+    BufferData second;
+    ASSERT_EQ(pool.acquire(second, 1916, 1080, BUFFER_USAGE_CSC), 0);
+    EXPECT_EQ(second.y, luma);
+    EXPECT_EQ(allocator->blocks, 2);
+    pool.release(second);
+
+    pool.trim();
+    EXPECT_EQ(pool.cachedBytes(), 0u);
+    EXPECT_EQ(allocator->blocks, 0);
+}
+
+TEST(GeoTransBufferPoolTest, KeepsOutstandingBuffersOnDestruction)
+{
+    auto allocator = std::make_shared<CountingAllocator>();
+    BufferData held, released;
+
+    {
+        BufferPool pool(allocator);
+        ASSERT_EQ(pool.acquire(held, 640, 480, BUFFER_USAGE_CSC), 0);
+        ASSERT_EQ(pool.acquire(released, 320, 240, BUFFER_USAGE_CSC), 0);
+        pool.release(released);
+    }
+
+    // Only the released planes were freed, the held ones stay usable.
+    EXPECT_EQ(allocator->blocks, 2);
+    held.y[0] = 1;
+    held.uv[640 * 240 - 1] = 1;
+
+    allocator->free(0, held.fdY, held.y);
+    allocator->free(0, held.fdUV, held.uv);
+}
+
+TEST(GeoTransBicubicTest, SameSizeCopies)
+{
+    Image src(96, 64), dst(96, 64);
+    src.fill();
+
+    ASSERT_EQ(runInterpBicubicFast(dst.buffer, src.buffer), 0);
+    EXPECT_EQ(dst.luma, src.luma);
+    EXPECT_EQ(dst.chroma, src.chroma);
+}
+
+TEST(GeoTransBicubicTest, MatchesReference)
+{
+    // Odd multiples of the SIMD width and stripe counts on purpose.
+    const int sizes[][4] = {
+        { 16, 16, 4, 4 }, { 16, 16, 62, 46 }, { 100, 60, 302, 182 },
+        { 640, 480, 1920, 1080 }, { 1920, 1080, 640, 362 }, { 1920, 1080, 1278, 718 },
+    };
+
+    for (auto& size : sizes) {
+        Image src(size[0], size[1]), dst(size[2], size[3]);
+        src.fill();
+
+        ASSERT_EQ(runInterpBicubicFast(dst.buffer, src.buffer), 0);
+
+        double error = maxError(dst, PIXEL_FORMAT_YUV_420_SP, [&](int plane, int x, int y, int c) {
+            return bicubicReference(src, size[2], size[3], plane, x, y, c);
+        });
+        EXPECT_LE(error, 1.0) << size[0] << "x" << size[1] << " to " << size[2] << "x" << size[3];
+    }
+}
+
+TEST(GeoTransBicubicTest, MatchesReferenceAtLargestSize)
+{
+    // Up to the documented 8192x8192, sampled on an odd step so that every SIMD lane and stripe is hit.
+    const int sizes[][4] = { { 4096, 4096, 8192, 8192 }, { 8192, 8192, 3002, 1998 } };
+
+    for (auto& size : sizes) {
+        Image src(size[0], size[1]), dst(size[2], size[3]);
+        src.fill();
+
+        ASSERT_EQ(runInterpBicubicFast(dst.buffer, src.buffer), 0);
+
+        double error = maxError(dst, PIXEL_FORMAT_YUV_420_SP, [&](int plane, int x, int y, int c) {
+            return bicubicReference(src, size[2], size[3], plane, x, y, c);
+        }, 7);
+        EXPECT_LE(error, 1.0) << size[0] << "x" << size[1] << " to " << size[2] << "x" << size[3];
+    }
+}
+
+TEST(GeoTransBicubicTest, ConcurrentCallsMatchSerial)
+{
+    Image src(1280, 720), expected(1920, 1080);
+    src.fill();
+    ASSERT_EQ(runInterpBicubicFast(expected.buffer, src.buffer), 0);
+
+    std::vector<std::unique_ptr<Image>> outputs;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        outputs.emplace_back(new Image(1920, 1080));
+        threads.emplace_back([&src, output = outputs.back().get()] {
+            for (int i = 0; i < 4; i++)
+                runInterpBicubicFast(output->buffer, src.buffer);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& output : outputs) {
+        EXPECT_EQ(output->luma, expected.luma);
+        EXPECT_EQ(output->chroma, expected.chroma);
+    }
+}
+
+TEST(GeoTransBicubicTest, RejectsInvalidBuffers)
+{
+    Image src(96, 64), dst(48, 33);
+
+    EXPECT_EQ(runInterpBicubicFast(dst.buffer, src.buffer), -EINVAL);
+    EXPECT_EQ(runInterpBicubicFast(dst.buffer, src.buffer, 0x2), -EINVAL);
+
+    dst.buffer.uv = NULL;
+    dst.buffer.height = 32;
+    EXPECT_EQ(runInterpBicubicFast(dst.buffer, src.buffer), -EINVAL);
+    EXPECT_EQ(runInterpBicubicFast(dst.buffer, src.buffer, PIXEL_FORMAT_Y_GRAY), 0);
+}
+
+// 8192 / 512 and 6144 / 384 are whole, so whole pixel displacements encode exactly.
+TEST(GeoTransGdcTest, ZeroGridCopies)
+{
+    Image src(512, 384), dst(512, 384);
+    src.fill();
+
+    Displacement none = {};
+    GDCGrid grid = encodeGrid(none, 512, 384);
+
+    ASSERT_EQ(runGDCGridTiled(dst.buffer, src.buffer, grid), 0);
+    EXPECT_EQ(dst.luma, src.luma);
+    EXPECT_EQ(dst.chroma, src.chroma);
+}
+
+TEST(GeoTransGdcTest, TranslationShiftsLuma)
+{
+    Image src(512, 384), dst(512, 384);
+    src.fill();
+
+    Displacement shift;
+    for (int row = 0; row < 33; row++) {
+        for (int col = 0; col < 33; col++) {
+            shift.dx[row][col] = 3;
+            shift.dy[row][col] = -2;
+        }
+    }
+    GDCGrid grid = encodeGrid(shift, 512, 384);
+
+    ASSERT_EQ(runGDCGridTiled(dst.buffer, src.buffer, grid), 0);
+
+    for (int y = 0; y < 384; y++)
+        for (int x = 0; x < 512; x++)
+            ASSERT_EQ(dst.at(0, x, y, 0), src.at(0, std::min(x + 3, 511), std::max(y - 2, 0), 0)) << x << "," << y;
+}
+
+TEST(GeoTransGdcTest, MatchesReference)
+{
+    const int sizes[][2] = { { 96, 64 }, { 512, 384 }, { 1920, 1088 } };
+
+    for (auto& size : sizes) {
+        Image src(size[0], size[1]), dst(size[0], size[1]);
+        src.fill();
+        GDCGrid grid = encodeGrid(rotation(size[0], size[1], 0.02), size[0], size[1]);
+
+        ASSERT_EQ(runGDCGridTiled(dst.buffer, src.buffer, grid), 0);
+
+        double error = maxError(dst, PIXEL_FORMAT_YUV_420_SP, [&](int plane, int x, int y, int c) {
+            return warpReference(src, grid, size[0], size[1], plane, x, y, c);
+        });
+        EXPECT_LE(error, 1.0) << size[0] << "x" << size[1];
+    }
+}
+
+TEST(GeoTransGdcTest, MatchesReferenceAtLargestSize)
+{
+    // 8192x6144 is the largest GDC input, checked on every 7th row and column.
+    Image src(8192, 6144), dst(8192, 6144);
+    src.fill();
+    GDCGrid grid = encodeGrid(rotation(8192, 6144, 0.02), 8192, 6144);
+
+    ASSERT_EQ(runGDCGridTiled(dst.buffer, src.buffer, grid), 0);
+
+    double error = maxError(dst, PIXEL_FORMAT_YUV_420_SP, [&](int plane, int x, int y, int c) {
+        return warpReference(src, grid, 8192, 6144, plane, x, y, c);
+    }, 7);
+    EXPECT_LE(error, 1.0);
+}
+
+TEST(GeoTransGdcTest, ScaledMatchesReference)
+{
+    const int sizes[][2] = { { 256, 192 }, { 640, 480 }, { 1022, 766 }, { 334, 250 } };
+    Image src(512, 384);
+    src.fill();
+    GDCGrid grid = encodeGrid(rotation(512, 384, -0.03), 512, 384);
+
+    for (auto& size : sizes) {
+        Image dst(size[0], size[1]);
+        ASSERT_TRUE(gdcScaleFoldable(dst.buffer, src.buffer));
+        ASSERT_EQ(runGDCGridTiledScaled(dst.buffer, src.buffer, grid), 0);
+
+        double error = maxError(dst, PIXEL_FORMAT_YUV_420_SP, [&](int plane, int x, int y, int c) {
+            return warpReference(src, grid, size[0], size[1], plane, x, y, c);
+        });
+        EXPECT_LE(error, 1.0) << size[0] << "x" << size[1];
+    }
+}
+
+TEST(GeoTransGdcTest, RejectsInvalidBuffers)
+{
+    Image src(512, 384), small(128, 96), odd(250, 191);
+    Displacement none = {};
+    GDCGrid grid = encodeGrid(none, 512, 384);
+
+    EXPECT_EQ(runGDCGridTiled(small.buffer, src.buffer, grid), -EINVAL);
+    EXPECT_FALSE(gdcScaleFoldable(small.buffer, src.buffer));
+    EXPECT_EQ(runGDCGridTiledScaled(small.buffer, src.buffer, grid), -EINVAL);
+    EXPECT_EQ(runGDCGridTiledScaled(odd.buffer, src.buffer, grid), -EINVAL);
+}